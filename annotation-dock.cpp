@@ -75,9 +75,7 @@ void AnnotationDock::onSaveAnnotationButton()
 	}
 
 	const QString annotationText = annotationEdit->toPlainText();
-	const QString timestamp = chapterDock->getCurrentRecordingTime();
-
-	chapterDock->writeAnnotationToFiles(annotationText, timestamp, obs_module_text("SourceManual"));
+	chapterDock->writeAnnotationToFiles(annotationText, chapterDock->getCurrentRecordingFrame(), MarkerSource::Kind::Manual);
 }
 
 void AnnotationDock::updateInputState(bool enabled)
@@ -0,0 +1,126 @@
+#include "annotation-store.hpp"
+#include <obs-module.h>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QMutexLocker>
+
+#define QT_TO_UTF8(str) str.toUtf8().constData()
+
+namespace {
+
+constexpr const char *STORE_HEADER = "# StreamUP annotation store 1\n";
+
+} // namespace
+
+void AnnotationStore::open(const QString &storeFilePath)
+{
+	QMutexLocker locker(&mutex);
+	if (storeFilePath == path) {
+		return;
+	}
+
+	// A new recording under the same name replaces the old store like every other sidecar
+	path = storeFilePath;
+	records.clear();
+	if (QFile::exists(path) && !QFile::remove(path)) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not replace annotation store: %s", QT_TO_UTF8(path));
+	}
+}
+
+QString AnnotationStore::filePath() const
+{
+	QMutexLocker locker(&mutex);
+	return path;
+}
+
+void AnnotationStore::relocate(const QString &fromPath, const QString &toPath)
+{
+	QMutexLocker locker(&mutex);
+	if (path == fromPath) {
+		path = toPath;
+	}
+}
+
+QString AnnotationStore::add(const QString &body)
+{
+	const QByteArray utf8 = body.toUtf8();
+	const QString id = makeId(utf8);
+
+	QMutexLocker locker(&mutex);
+	if (records.contains(id)) {
+		return id;
+	}
+	if (path.isEmpty()) {
+		return QString();
+	}
+
+	QFile file(path);
+	if (!file.open(QIODevice::ReadWrite | QIODevice::Append)) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open annotation store: %s", QT_TO_UTF8(path));
+		return QString();
+	}
+
+	QByteArray record;
+	if (file.size() == 0) {
+		record += STORE_HEADER;
+	}
+	record += '@' + id.toLatin1() + ' ' + QByteArray::number(utf8.size()) + '\n';
+	const qint64 offset = file.size() + record.size();
+	record += utf8;
+	record += '\n';
+
+	if (file.write(record) != record.size()) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to write annotation store: %s", QT_TO_UTF8(path));
+		return QString();
+	}
+
+	records.insert(id, {offset, utf8.size()});
+	return id;
+}
+
+bool AnnotationStore::body(const QString &id, QString &out) const
+{
+	QMutexLocker locker(&mutex);
+	const auto record = records.constFind(id);
+	if (record == records.constEnd()) {
+		return false;
+	}
+
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly) || !file.seek(record->offset)) {
+		return false;
+	}
+	const QByteArray utf8 = file.read(record->length);
+	if (utf8.size() != record->length) {
+		return false;
+	}
+	out = QString::fromUtf8(utf8);
+	return true;
+}
+
+QString AnnotationStore::makeId(const QByteArray &utf8Body)
+{
+	return QString::fromLatin1(QCryptographicHash::hash(utf8Body, QCryptographicHash::Sha256).toHex().left(ID_LENGTH));
+}
+
+QString AnnotationStore::makeTitle(const QString &body, int maxLength)
+{
+	// First non-empty line, cut at a word boundary when it is too long
+	QString title;
+	for (const QString &line : body.split('\n')) {
+		title = line.trimmed();
+		if (!title.isEmpty()) {
+			break;
+		}
+	}
+
+	if (title.size() <= maxLength) {
+		return title;
+	}
+
+	int cut = title.lastIndexOf(' ', maxLength);
+	if (cut < maxLength / 2) {
+		cut = maxLength;
+	}
+	return title.left(cut).trimmed() + QString::fromUtf8("…");
+}
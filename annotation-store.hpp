@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef ANNOTATION_STORE_HPP
+#define ANNOTATION_STORE_HPP
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @class AnnotationStore
+ * @brief Content-addressed sidecar holding each annotation body once per recording
+ *
+ * Bodies are keyed by a short SHA-256 prefix, so the same note saved twice is
+ * stored once and the export formats only carry a title and the id. Records
+ * are appended as "@<id> <byte length>" followed by the UTF-8 body, the file
+ * is created with the first annotation. The store may be read from the
+ * WebSocket thread while the UI thread appends, both go through the mutex.
+ */
+class AnnotationStore {
+public:
+	static constexpr int ID_LENGTH = 12;
+
+	// Reopening the current path keeps its records, any other path starts empty
+	void open(const QString &storeFilePath);
+
+	// Returns the id of the stored body, or an empty string if it could not be written
+	QString add(const QString &body);
+	bool body(const QString &id, QString &out) const;
+	QString filePath() const;
+	// Follows the store after its file was moved, ignored once another recording opened a new store
+	void relocate(const QString &fromPath, const QString &toPath);
+
+	static QString makeId(const QByteArray &utf8Body);
+	static QString makeTitle(const QString &body, int maxLength);
+
+private:
+	struct Record {
+		qint64 offset;
+		qint64 length;
+	};
+
+	mutable QMutex mutex;
+	QString path;
+	QHash<QString, Record> records;
+};
+
+#endif // ANNOTATION_STORE_HPP
@@ -0,0 +1,89 @@
+#include "audio-level.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_LEVEL_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define AUDIO_LEVEL_NEON
+#endif
+
+namespace AudioLevel {
+
+float toDb(float amplitude)
+{
+	return amplitude > 0.0f ? 20.0f * std::log10(amplitude) : -std::numeric_limits<float>::infinity();
+}
+
+float Level::rmsDb() const
+{
+	return samples ? toDb(std::sqrt(sumSquares / static_cast<float>(samples))) : -std::numeric_limits<float>::infinity();
+}
+
+float Level::peakDb() const
+{
+	return toDb(peak);
+}
+
+void accumulateScalar(Level &level, const float *samples, size_t count)
+{
+	float sumSquares = 0.0f;
+	float peak = level.peak;
+	for (size_t i = 0; i < count; ++i) {
+		const float sample = samples[i];
+		sumSquares += sample * sample;
+		peak = std::max(peak, std::fabs(sample));
+	}
+	level.sumSquares += sumSquares;
+	level.peak = peak;
+	level.samples += count;
+}
+
+void accumulate(Level &level, const float *samples, size_t count)
+{
+	size_t i = 0;
+
+#if defined(AUDIO_LEVEL_SSE2)
+	// Two accumulators hide the add latency, clearing the sign bit gives the absolute value
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 sum0 = _mm_setzero_ps();
+	__m128 sum1 = _mm_setzero_ps();
+	__m128 peaks = _mm_setzero_ps();
+	for (; i + 8 <= count; i += 8) {
+		const __m128 a = _mm_loadu_ps(samples + i);
+		const __m128 b = _mm_loadu_ps(samples + i + 4);
+		sum0 = _mm_add_ps(sum0, _mm_mul_ps(a, a));
+		sum1 = _mm_add_ps(sum1, _mm_mul_ps(b, b));
+		peaks = _mm_max_ps(peaks, _mm_max_ps(_mm_and_ps(a, absMask), _mm_and_ps(b, absMask)));
+	}
+
+	alignas(16) float sums[4];
+	alignas(16) float maxima[4];
+	_mm_store_ps(sums, _mm_add_ps(sum0, sum1));
+	_mm_store_ps(maxima, peaks);
+	level.sumSquares += (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	level.peak = std::max({level.peak, maxima[0], maxima[1], maxima[2], maxima[3]});
+	level.samples += i;
+#elif defined(AUDIO_LEVEL_NEON)
+	float32x4_t sum0 = vdupq_n_f32(0.0f);
+	float32x4_t sum1 = vdupq_n_f32(0.0f);
+	float32x4_t peaks = vdupq_n_f32(0.0f);
+	for (; i + 8 <= count; i += 8) {
+		const float32x4_t a = vld1q_f32(samples + i);
+		const float32x4_t b = vld1q_f32(samples + i + 4);
+		sum0 = vmlaq_f32(sum0, a, a);
+		sum1 = vmlaq_f32(sum1, b, b);
+		peaks = vmaxq_f32(peaks, vmaxq_f32(vabsq_f32(a), vabsq_f32(b)));
+	}
+	level.sumSquares += vaddvq_f32(vaddq_f32(sum0, sum1));
+	level.peak = std::max(level.peak, vmaxvq_f32(peaks));
+	level.samples += i;
+#endif
+
+	accumulateScalar(level, samples + i, count - i);
+}
+
+} // namespace AudioLevel
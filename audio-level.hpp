@@ -0,0 +1,37 @@
+#pragma once
+
+#ifndef AUDIO_LEVEL_HPP
+#define AUDIO_LEVEL_HPP
+
+#include <cstddef>
+
+/**
+ * @namespace AudioLevel
+ * @brief Sum of squares and peak of float samples, for the audio thread
+ *
+ * accumulate() handles 8 samples per step with SSE2 or NEON where available
+ * and finishes the tail with the scalar loop. Neither allocates, a packet of
+ * 1024 stereo frames takes well under a microsecond.
+ */
+namespace AudioLevel {
+
+struct Level {
+	float sumSquares = 0.0f;
+	float peak = 0.0f; // Absolute value
+	size_t samples = 0;
+
+	// Both in dBFS, -inf for digital silence
+	float rmsDb() const;
+	float peakDb() const;
+};
+
+void accumulate(Level &level, const float *samples, size_t count);
+
+// Scalar reference for accumulate, also used for the tail of the SIMD loop
+void accumulateScalar(Level &level, const float *samples, size_t count);
+
+float toDb(float amplitude);
+
+} // namespace AudioLevel
+
+#endif // AUDIO_LEVEL_HPP
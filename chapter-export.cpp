@@ -0,0 +1,231 @@
+#include "chapter-export.hpp"
+
+namespace ChapterExport {
+
+const char FCPXML_FOOTER[] = "          </clipitem>\n"
+			     "        </track>\n"
+			     "      </video>\n"
+			     "    </media>\n"
+			     "  </clip>\n"
+			     "</xmeml>\n";
+
+const char PREMIEREXML_FOOTER[] = "\t</sequence>\n</xmeml>\n";
+
+void appendEscaped(QByteArray &out, const QString &text, TextEscape::Mode mode)
+{
+	const QByteArray utf8 = text.toUtf8();
+	TextEscape::append(out, utf8.constData(), static_cast<size_t>(utf8.size()), mode);
+}
+
+QByteArray escaped(const QString &text, TextEscape::Mode mode)
+{
+	QByteArray out;
+	appendEscaped(out, text, mode);
+	return out;
+}
+
+QString fullName(const QString &name, const QString &sourceLabel, bool addSource)
+{
+	// Ensure the chapter source is only appended once
+	if (addSource && !name.contains(sourceLabel)) {
+		return name + " (" + sourceLabel + ")";
+	}
+	return name;
+}
+
+static void appendFrames(QByteArray &out, uint64_t frameOffset)
+{
+	char frames[Timecode::BUFFER_SIZE];
+	out.append(frames, static_cast<qsizetype>(Timecode::formatFrames(frames, frameOffset)));
+}
+
+//--------------------TEXT--------------------
+QByteArray textHeader(const QString &baseName)
+{
+	return "Chapter Markers for " + baseName.toUtf8() + "\n";
+}
+
+QByteArray textMarker(const QString &fullChapterName, uint64_t frameOffset, const Timecode::Timebase &timebase)
+{
+	char timestamp[Timecode::BUFFER_SIZE];
+	QByteArray content(timestamp, static_cast<qsizetype>(Timecode::formatHms(timestamp, frameOffset, timebase)));
+	content += " - ";
+	appendEscaped(content, fullChapterName, TextEscape::Mode::TextLine);
+	content += '\n';
+	return content;
+}
+
+//--------------------FINAL CUT PRO XML--------------------
+QByteArray fcpXmlHeader(const QString &baseName, const Timecode::Timebase &timebase)
+{
+	QByteArray out;
+	out += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	out += "<!DOCTYPE xmeml>\n";
+	out += "<xmeml version=\"5\">\n";
+	out += "  <clip>\n";
+	out += "    <rate>\n";
+	out += "      <timebase>" + QByteArray::number(timebase.nominalFps()) + "</timebase>\n";
+	out += "    </rate>\n";
+	out += "    <media>\n";
+	out += "      <video>\n";
+	out += "        <track>\n";
+	out += "          <clipitem>\n";
+	out += "            <file id=\"file1\">\n";
+	out += "              <pathurl>" + escaped(baseName, TextEscape::Mode::Xml) + "</pathurl>\n";
+	out += "              <media>\n";
+	out += "                <video/>\n";
+	out += "              </media>\n";
+	out += "            </file>\n";
+	return out;
+}
+
+QByteArray fcpXmlMarker(const QString &chapterName, const QString &fullChapterName, uint64_t frameOffset)
+{
+	QByteArray marker;
+	marker += "            <marker>\n";
+	marker += "              <comment>";
+	appendEscaped(marker, fullChapterName, TextEscape::Mode::Xml);
+	marker += "</comment>\n";
+	marker += "              <name>";
+	appendEscaped(marker, chapterName, TextEscape::Mode::Xml);
+	marker += "</name>\n";
+	marker += "              <in>";
+	appendFrames(marker, frameOffset);
+	marker += "</in>\n";
+	marker += "              <out>-1</out>\n";
+	marker += "            </marker>\n";
+	return marker;
+}
+
+//--------------------PREMIERE XML--------------------
+QByteArray premiereXmlHeader(const QString &baseName, const Timecode::Timebase &timebase)
+{
+	const QByteArray fps = QByteArray::number(timebase.nominalFps());
+	const char *ntsc = timebase.isNtsc() ? "TRUE" : "FALSE";
+	char startTimecode[Timecode::BUFFER_SIZE];
+	const size_t startLength = Timecode::formatPremiere(startTimecode, 0, timebase);
+
+	QByteArray out;
+	out += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+	out += "<!DOCTYPE xmeml>\n";
+	out += "<xmeml version=\"4\">\n";
+	out += "\t<sequence id=\"sequence-1\">\n";
+	out += "\t\t<name>" + escaped(baseName, TextEscape::Mode::Xml) + "</name>\n";
+	out += "\t\t<rate>\n";
+	out += "\t\t\t<timebase>" + fps + "</timebase>\n";
+	out += "\t\t\t<ntsc>" + QByteArray(ntsc) + "</ntsc>\n";
+	out += "\t\t</rate>\n";
+	out += "\t\t<media>\n";
+	out += "\t\t\t<video>\n";
+	out += "\t\t\t\t<track>\n";
+	out += "\t\t\t\t\t<enabled>TRUE</enabled>\n";
+	out += "\t\t\t\t\t<locked>FALSE</locked>\n";
+	out += "\t\t\t\t</track>\n";
+	out += "\t\t\t</video>\n";
+	out += "\t\t</media>\n";
+	out += "\t\t<timecode>\n";
+	out += "\t\t\t<rate>\n";
+	out += "\t\t\t\t<timebase>" + fps + "</timebase>\n";
+	out += "\t\t\t\t<ntsc>" + QByteArray(ntsc) + "</ntsc>\n";
+	out += "\t\t\t</rate>\n";
+	out += "\t\t\t<string>" + QByteArray(startTimecode, static_cast<qsizetype>(startLength)) + "</string>\n";
+	out += "\t\t\t<frame>0</frame>\n";
+	out += "\t\t\t<displayformat>" + QByteArray(timebase.isNtsc() ? "DF" : "NDF") + "</displayformat>\n";
+	out += "\t\t</timecode>\n";
+	return out;
+}
+
+QByteArray premiereXmlMarker(const QString &fullChapterName, uint64_t frameOffset)
+{
+	QByteArray marker;
+	marker += "\t\t<marker>\n";
+	marker += "\t\t\t<comment></comment>\n";
+	marker += "\t\t\t<name>";
+	appendEscaped(marker, fullChapterName, TextEscape::Mode::Xml);
+	marker += "</name>\n";
+	marker += "\t\t\t<in>";
+	appendFrames(marker, frameOffset);
+	marker += "</in>\n";
+	marker += "\t\t\t<out>-1</out>\n";
+	marker += "\t\t</marker>\n";
+	return marker;
+}
+
+//--------------------EDL--------------------
+QByteArray edlHeader(const QString &title)
+{
+	return "TITLE: " + escaped(title, TextEscape::Mode::EdlComment) + "\nFCM: NON-DROP FRAME\n\n";
+}
+
+QByteArray edlMarker(const QString &chapterName, const QString &fullChapterName, uint64_t frameOffset,
+		     const Timecode::Timebase &timebase, int eventNumber, const char *markerColor, int reelNumber)
+{
+	// Timecodes are HH:MM:SS:FF non-drop, one frame long, record times start at 01:00:00:00
+	char timecodeStart[Timecode::BUFFER_SIZE];
+	char timecodeEnd[Timecode::BUFFER_SIZE];
+	const qsizetype startLength =
+		static_cast<qsizetype>(Timecode::formatSmpte(timecodeStart, frameOffset, timebase, false, 0, EDL_HOUR_OFFSET));
+	const qsizetype endLength =
+		static_cast<qsizetype>(Timecode::formatSmpte(timecodeEnd, frameOffset + 1, timebase, false, 0, EDL_HOUR_OFFSET));
+	char eventText[Timecode::BUFFER_SIZE];
+	const qsizetype eventLength = static_cast<qsizetype>(Timecode::formatEventNumber(eventText, static_cast<uint32_t>(eventNumber)));
+	char reelText[Timecode::BUFFER_SIZE];
+	const qsizetype reelLength = static_cast<qsizetype>(Timecode::formatEventNumber(reelText, static_cast<uint32_t>(reelNumber)));
+
+	// EDL format:
+	// Event#  Reel   Track  Type  Source In  Source Out  Record In  Record Out
+	// Comment line with marker info
+	QByteArray event;
+	event.append(eventText, eventLength);
+	event += "  ";
+	event.append(reelText, reelLength);
+	event += "      V     C        ";
+	event.append(timecodeStart, startLength).append(' ').append(timecodeEnd, endLength).append(' ');
+	event.append(timecodeStart, startLength).append(' ').append(timecodeEnd, endLength);
+	event += "  \n";
+
+	// The color gives each source its own marker color in DaVinci Resolve
+	appendEscaped(event, fullChapterName, TextEscape::Mode::EdlComment);
+	event += " |C:";
+	event += markerColor;
+	event += " |M:";
+	appendEscaped(event, chapterName, TextEscape::Mode::EdlComment);
+	event += " |D:1\n\n";
+	return event;
+}
+
+//--------------------CUSTOM TEMPLATE--------------------
+void setTemplateFields(QString *fieldValues, const ExportTemplate &exportTemplate, const QString &name, uint64_t frameOffset,
+		       const QString &source, int index, const Timecode::Timebase &timebase)
+{
+	char buffer[Timecode::BUFFER_SIZE];
+	fieldValues[ExportTemplate::FieldTime] =
+		QString::fromLatin1(buffer, static_cast<qsizetype>(Timecode::formatHms(buffer, frameOffset, timebase)));
+	fieldValues[ExportTemplate::FieldName] = name;
+	fieldValues[ExportTemplate::FieldSource] = source;
+	fieldValues[ExportTemplate::FieldIndex] = QString::number(index);
+	fieldValues[ExportTemplate::FieldRef].clear();
+
+	// Frame based fields are only worked out when the template asks for them
+	if (exportTemplate.usesField(ExportTemplate::FieldFrame)) {
+		fieldValues[ExportTemplate::FieldFrame] =
+			QString::fromLatin1(buffer, static_cast<qsizetype>(Timecode::formatFrames(buffer, frameOffset)));
+	}
+	if (exportTemplate.usesField(ExportTemplate::FieldTimecode)) {
+		// Same record timecode the EDL export writes
+		fieldValues[ExportTemplate::FieldTimecode] = QString::fromLatin1(
+			buffer, static_cast<qsizetype>(Timecode::formatSmpte(buffer, frameOffset, timebase, false, 0, EDL_HOUR_OFFSET)));
+	}
+}
+
+QByteArray renderTemplate(const TextTemplate &textTemplate, const QString *fieldValues, QByteArray &buffer)
+{
+	buffer.resize(0);
+	textTemplate.render(buffer, fieldValues);
+	if (!buffer.isEmpty()) {
+		buffer += '\n';
+	}
+	return buffer;
+}
+
+} // namespace ChapterExport
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef CHAPTER_EXPORT_HPP
+#define CHAPTER_EXPORT_HPP
+
+#include "text-escape.hpp"
+#include "text-template.hpp"
+#include "timecode-format.hpp"
+#include <QByteArray>
+#include <QString>
+#include <cstdint>
+
+/**
+ * @namespace ChapterExport
+ * @brief Byte-exact layout of every sidecar format
+ *
+ * Shared by the dock, which appends these pieces live, and by the offline
+ * converter, which renders whole files from a chapter index. Only depends on
+ * Qt Core so the converter builds without OBS. Output uses '\n' line endings,
+ * writers convert them for the platform.
+ */
+namespace ChapterExport {
+
+// EDL record times start at 01:00:00:00
+constexpr int EDL_HOUR_OFFSET = 1;
+
+extern const char FCPXML_FOOTER[];
+extern const char PREMIEREXML_FOOTER[];
+
+void appendEscaped(QByteArray &out, const QString &text, TextEscape::Mode mode);
+QByteArray escaped(const QString &text, TextEscape::Mode mode);
+
+// Name with the source appended once, when the source is enabled and not already part of it
+QString fullName(const QString &name, const QString &sourceLabel, bool addSource);
+
+QByteArray textHeader(const QString &baseName);
+QByteArray textMarker(const QString &fullChapterName, uint64_t frameOffset, const Timecode::Timebase &timebase);
+
+QByteArray fcpXmlHeader(const QString &baseName, const Timecode::Timebase &timebase);
+QByteArray fcpXmlMarker(const QString &chapterName, const QString &fullChapterName, uint64_t frameOffset);
+
+QByteArray premiereXmlHeader(const QString &baseName, const Timecode::Timebase &timebase);
+QByteArray premiereXmlMarker(const QString &fullChapterName, uint64_t frameOffset);
+
+QByteArray edlHeader(const QString &title);
+// reelNumber tells merged timelines' tracks apart, a single recording is reel 001
+QByteArray edlMarker(const QString &chapterName, const QString &fullChapterName, uint64_t frameOffset,
+		     const Timecode::Timebase &timebase, int eventNumber, const char *markerColor, int reelNumber = 1);
+
+// Fills the ExportTemplate fields, frame based ones only when the template uses them
+void setTemplateFields(QString *fieldValues, const ExportTemplate &exportTemplate, const QString &name, uint64_t frameOffset,
+		       const QString &source, int index, const Timecode::Timebase &timebase);
+// Renders one template line into the reused buffer, empty templates produce no line
+QByteArray renderTemplate(const TextTemplate &textTemplate, const QString *fieldValues, QByteArray &buffer);
+
+} // namespace ChapterExport
+
+#endif // CHAPTER_EXPORT_HPP
@@ -0,0 +1,98 @@
+#include "chapter-fanout.hpp"
+#include "constants.hpp"
+#include <obs.h>
+#include <util/platform.h>
+#include <QRegularExpression>
+#include <algorithm>
+
+ChapterFanout::ChapterFanout()
+{
+	// One thread, every target sees the chapters in order
+	worker.setMaxThreadCount(1);
+	worker.setExpiryTimeout(-1);
+	pendingTargets << Constants::AITUM_VERTICAL_PROC;
+}
+
+QStringList ChapterFanout::parseTargets(const QString &text)
+{
+	static const QRegularExpression separators("[,;\\s]+");
+	QStringList procNames;
+	for (const QString &procName : text.split(separators, Qt::SkipEmptyParts)) {
+		if (!procNames.contains(procName)) {
+			procNames << procName;
+		}
+	}
+	return procNames;
+}
+
+void ChapterFanout::start()
+{
+	if (pendingTargets.isEmpty()) {
+		session.reset();
+		return;
+	}
+
+	session = std::make_shared<Session>(static_cast<size_t>(pendingTargets.size()));
+	session->procHandler = obs_get_proc_handler();
+	for (size_t i = 0; i < session->targets.size(); ++i) {
+		session->targets[i].procName = pendingTargets.at(static_cast<qsizetype>(i)).toUtf8();
+	}
+}
+
+void ChapterFanout::dispatch(const char *chapterNameUtf8)
+{
+	if (!session || !session->procHandler) {
+		return;
+	}
+
+	worker.start([target = session, chapterName = QByteArray(chapterNameUtf8)]() { call(*target, chapterName); });
+}
+
+void ChapterFanout::stop()
+{
+	if (!session) {
+		return;
+	}
+
+	worker.start([target = std::move(session)]() { logStatistics(*target); });
+}
+
+void ChapterFanout::call(Session &session, const QByteArray &chapterName)
+{
+	for (Target &target : session.targets) {
+		if (target.missing) {
+			continue;
+		}
+
+		calldata_set_string(&target.calldata, Constants::AITUM_VERTICAL_PARAM, chapterName.constData());
+		const uint64_t startNs = os_gettime_ns();
+		const bool called = proc_handler_call(session.procHandler, target.procName.constData(), &target.calldata);
+		const uint64_t elapsedNs = os_gettime_ns() - startNs;
+
+		if (!called) {
+			++target.failures;
+			if (target.calls == 0) {
+				target.missing = true;
+				blog(LOG_INFO, "[StreamUP Record Chapter Manager] Chapter target %s is not available, skipping it",
+				     target.procName.constData());
+			}
+			continue;
+		}
+
+		++target.calls;
+		target.totalNs += elapsedNs;
+		target.maxNs = std::max(target.maxNs, elapsedNs);
+	}
+}
+
+void ChapterFanout::logStatistics(const Session &session)
+{
+	for (const Target &target : session.targets) {
+		if (target.calls == 0) {
+			continue;
+		}
+		blog(LOG_INFO, "[StreamUP Record Chapter Manager] Chapter target %s: %d calls, %d failed, average %.3f ms, max %.3f ms",
+		     target.procName.constData(), target.calls, target.failures,
+		     static_cast<double>(target.totalNs) / target.calls / 1000000.0, static_cast<double>(target.maxNs) / 1000000.0);
+	}
+}
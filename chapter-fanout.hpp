@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef CHAPTER_FANOUT_HPP
+#define CHAPTER_FANOUT_HPP
+
+#include <callback/calldata.h>
+#include <callback/proc.h>
+#include <QByteArray>
+#include <QStringList>
+#include <QThreadPool>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class ChapterFanout
+ * @brief Sends each chapter to the procs of other plugins, such as Aitum Vertical, off the UI thread
+ *
+ * The target procs are fixed when the recording starts: their names are
+ * converted once and each target keeps its own calldata, so a chapter only
+ * overwrites the name parameter in a buffer that is already allocated. Calls
+ * run on a single worker thread, which keeps every target receiving chapters
+ * in the order they were set, and a slow plugin cannot stall the dock.
+ *
+ * libobs has no way to ask whether a proc exists without calling it, so a
+ * target whose first call fails is treated as missing and skipped for the
+ * rest of the recording. Call counts, failures and latency are logged per
+ * target when the recording stops.
+ */
+class ChapterFanout {
+public:
+	ChapterFanout();
+
+	// Takes effect at the next start, settings can change while recording
+	void setTargets(const QStringList &procNames) { pendingTargets = procNames; }
+	const QStringList &targets() const { return pendingTargets; }
+
+	void start();
+	void dispatch(const char *chapterNameUtf8);
+	// Queues the statistics after the chapters still waiting, does not block
+	void stop();
+
+	static QStringList parseTargets(const QString &text);
+
+private:
+	struct Target {
+		QByteArray procName;
+		calldata_t calldata;
+		bool missing = false;
+		int calls = 0;
+		int failures = 0;
+		uint64_t totalNs = 0;
+		uint64_t maxNs = 0;
+
+		Target() { calldata_init(&calldata); }
+		~Target() { calldata_free(&calldata); }
+		Target(const Target &) = delete;
+		Target &operator=(const Target &) = delete;
+	};
+
+	// Owned by the tasks of one recording, a new recording never touches the previous one's buffers
+	struct Session {
+		explicit Session(size_t count) : targets(count) {}
+		proc_handler_t *procHandler = nullptr;
+		std::vector<Target> targets;
+	};
+
+	static void call(Session &session, const QByteArray &chapterName);
+	static void logStatistics(const Session &session);
+
+	QStringList pendingTargets;
+	std::shared_ptr<Session> session;
+	QThreadPool worker;
+};
+
+#endif // CHAPTER_FANOUT_HPP
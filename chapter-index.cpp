@@ -0,0 +1,322 @@
+#include "chapter-index.hpp"
+#include <QtEndian>
+#include <cstring>
+
+namespace ChapterIndex {
+
+namespace {
+
+template<typename T> void put(QByteArray &out, size_t offset, T value)
+{
+	qToLittleEndian<T>(value, reinterpret_cast<uchar *>(out.data()) + offset);
+}
+
+template<typename T> T get(const uchar *data, size_t offset)
+{
+	return qFromLittleEndian<T>(data + offset);
+}
+
+QByteArray encodeHeader(const Header &header)
+{
+	QByteArray out(sizeof(Header), '\0');
+	std::memcpy(out.data(), header.magic, sizeof(header.magic));
+	put(out, offsetof(Header, version), header.version);
+	put(out, offsetof(Header, headerSize), header.headerSize);
+	put(out, offsetof(Header, recordSize), header.recordSize);
+	put(out, offsetof(Header, flags), header.flags);
+	put(out, offsetof(Header, fpsNum), header.fpsNum);
+	put(out, offsetof(Header, fpsDen), header.fpsDen);
+	put(out, offsetof(Header, recordsOffset), header.recordsOffset);
+	put(out, offsetof(Header, recordCapacity), header.recordCapacity);
+	put(out, offsetof(Header, recordCount), header.recordCount);
+	put(out, offsetof(Header, stringTableOffset), header.stringTableOffset);
+	put(out, offsetof(Header, stringTableSize), header.stringTableSize);
+	put(out, offsetof(Header, startMonotonicNs), header.startMonotonicNs);
+	put(out, offsetof(Header, startWallClockNs), header.startWallClockNs);
+	return out;
+}
+
+QByteArray encodeRecord(const Record &record)
+{
+	QByteArray out(sizeof(Record), '\0');
+	put(out, offsetof(Record, frameOffset), record.frameOffset);
+	put(out, offsetof(Record, nameOffset), record.nameOffset);
+	put(out, offsetof(Record, nameLength), record.nameLength);
+	put(out, offsetof(Record, sourceOffset), record.sourceOffset);
+	put(out, offsetof(Record, sourceLength), record.sourceLength);
+	put(out, offsetof(Record, sourceKind), record.sourceKind);
+	put(out, offsetof(Record, flags), record.flags);
+	put(out, offsetof(Record, markerId), record.markerId);
+	return out;
+}
+
+} // namespace
+
+bool readHeader(const uchar *data, qint64 size, Header &out)
+{
+	if (!data || size < HEADER_SIZE_V1 || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+		return false;
+	}
+
+	std::memcpy(out.magic, data, sizeof(out.magic));
+	out.version = get<uint16_t>(data, offsetof(Header, version));
+	out.headerSize = get<uint16_t>(data, offsetof(Header, headerSize));
+	out.recordSize = get<uint16_t>(data, offsetof(Header, recordSize));
+	out.flags = get<uint16_t>(data, offsetof(Header, flags));
+	out.fpsNum = get<uint32_t>(data, offsetof(Header, fpsNum));
+	out.fpsDen = get<uint32_t>(data, offsetof(Header, fpsDen));
+	out.recordsOffset = get<uint64_t>(data, offsetof(Header, recordsOffset));
+	out.recordCapacity = get<uint32_t>(data, offsetof(Header, recordCapacity));
+	out.recordCount = get<uint32_t>(data, offsetof(Header, recordCount));
+	out.stringTableOffset = get<uint64_t>(data, offsetof(Header, stringTableOffset));
+	out.stringTableSize = get<uint64_t>(data, offsetof(Header, stringTableSize));
+	out.reserved = 0;
+
+	// Later versions may only add fields at the end of the header and of each record
+	if (out.version < 1 || out.headerSize < HEADER_SIZE_V1 || out.headerSize > size || out.recordSize < sizeof(Record) ||
+	    out.recordCount > out.recordCapacity) {
+		return false;
+	}
+	const bool hasAnchor = out.headerSize >= sizeof(Header);
+	out.startMonotonicNs = hasAnchor ? get<uint64_t>(data, offsetof(Header, startMonotonicNs)) : 0;
+	out.startWallClockNs = hasAnchor ? get<int64_t>(data, offsetof(Header, startWallClockNs)) : 0;
+	const uint64_t fileSize = static_cast<uint64_t>(size);
+	return out.recordsOffset >= out.headerSize &&
+	       out.recordsOffset + static_cast<uint64_t>(out.recordCount) * out.recordSize <= fileSize &&
+	       out.stringTableOffset + out.stringTableSize <= fileSize;
+}
+
+Record readRecord(const uchar *data, const Header &header, uint32_t index)
+{
+	const uchar *base = data + header.recordsOffset + static_cast<uint64_t>(index) * header.recordSize;
+	Record record = {};
+	record.frameOffset = get<uint64_t>(base, offsetof(Record, frameOffset));
+	record.nameOffset = get<uint32_t>(base, offsetof(Record, nameOffset));
+	record.nameLength = get<uint32_t>(base, offsetof(Record, nameLength));
+	record.sourceOffset = get<uint32_t>(base, offsetof(Record, sourceOffset));
+	record.sourceLength = get<uint32_t>(base, offsetof(Record, sourceLength));
+	record.sourceKind = base[offsetof(Record, sourceKind)];
+	record.flags = base[offsetof(Record, flags)];
+	record.markerId = get<uint32_t>(base, offsetof(Record, markerId));
+	return record;
+}
+
+uint32_t lowerBound(const uchar *data, const Header &header, uint64_t frameOffset)
+{
+	uint32_t low = 0;
+	uint32_t high = header.recordCount;
+	while (low < high) {
+		const uint32_t middle = low + (high - low) / 2;
+		const uchar *base = data + header.recordsOffset + static_cast<uint64_t>(middle) * header.recordSize;
+		if (get<uint64_t>(base, offsetof(Record, frameOffset)) < frameOffset) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+} // namespace ChapterIndex
+
+bool ChapterIndexWriter::create(const QString &filePath, const Timecode::Timebase &timebase,
+				const ChapterIndex::SessionAnchor &anchor)
+{
+	close();
+
+	file.setFileName(filePath);
+	if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+		return false;
+	}
+
+	header = {};
+	std::memcpy(header.magic, ChapterIndex::MAGIC, sizeof(header.magic));
+	header.version = ChapterIndex::VERSION;
+	header.headerSize = sizeof(ChapterIndex::Header);
+	header.recordSize = sizeof(ChapterIndex::Record);
+	header.fpsNum = timebase.fpsNum;
+	header.fpsDen = timebase.fpsDen;
+	header.recordsOffset = sizeof(ChapterIndex::Header);
+	header.recordCapacity = INITIAL_CAPACITY;
+	header.stringTableOffset = header.recordsOffset + static_cast<uint64_t>(INITIAL_CAPACITY) * header.recordSize;
+	header.startMonotonicNs = anchor.monotonicNs;
+	header.startWallClockNs = anchor.wallClockNs;
+
+	// Empty record slots are zero filled, the string table starts right after them
+	if (!file.resize(static_cast<qint64>(header.stringTableOffset)) || !writeHeader() || !file.flush()) {
+		file.close();
+		return false;
+	}
+	return true;
+}
+
+void ChapterIndexWriter::close()
+{
+	if (file.isOpen()) {
+		header.flags |= ChapterIndex::HeaderComplete;
+		writeHeader();
+		file.close();
+	}
+
+	stringOffsets.clear();
+	recordIndexByMarker.clear();
+	records.clear();
+}
+
+bool ChapterIndexWriter::append(uint64_t frameOffset, uint32_t markerId, uint8_t sourceKind, uint8_t flags, const QString &name,
+				const QString &source)
+{
+	if (!file.isOpen() || (header.recordCount == header.recordCapacity && !growRecords())) {
+		return false;
+	}
+
+	ChapterIndex::Record record = {};
+	record.frameOffset = frameOffset;
+	record.sourceKind = sourceKind;
+	record.flags = flags;
+	record.markerId = markerId;
+	if (!addString(name, record.nameOffset, record.nameLength) ||
+	    !addString(source, record.sourceOffset, record.sourceLength)) {
+		return false;
+	}
+
+	// The record is complete on disk before the count that makes it visible
+	const uint32_t index = header.recordCount;
+	if (!writeRecord(index, record)) {
+		return false;
+	}
+	header.recordCount++;
+	records.append(record);
+	if (markerId != ChapterIndex::NO_MARKER_ID) {
+		recordIndexByMarker.insert(markerId, index);
+	}
+	return writeHeader() && file.flush();
+}
+
+bool ChapterIndexWriter::renameMarker(uint32_t markerId, const QString &name)
+{
+	const auto found = recordIndexByMarker.constFind(markerId);
+	if (!file.isOpen() || found == recordIndexByMarker.constEnd()) {
+		return false;
+	}
+
+	// The old name stays in the string table, only the record points elsewhere
+	ChapterIndex::Record &record = records[*found];
+	if (!addString(name, record.nameOffset, record.nameLength) || !writeHeader()) {
+		return false;
+	}
+	return writeRecord(*found, record) && file.flush();
+}
+
+bool ChapterIndexWriter::markDeleted(uint32_t markerId)
+{
+	const auto found = recordIndexByMarker.constFind(markerId);
+	if (!file.isOpen() || found == recordIndexByMarker.constEnd()) {
+		return false;
+	}
+
+	ChapterIndex::Record &record = records[*found];
+	record.flags |= ChapterIndex::RecordDeleted;
+	return writeRecord(*found, record) && file.flush();
+}
+
+bool ChapterIndexWriter::addString(const QString &text, uint32_t &offset, uint32_t &length)
+{
+	const QByteArray utf8 = text.toUtf8();
+	length = static_cast<uint32_t>(utf8.size());
+
+	const auto found = stringOffsets.constFind(utf8);
+	if (found != stringOffsets.constEnd()) {
+		offset = *found;
+		return true;
+	}
+
+	// Written past the size in the header, it only becomes part of the table when the header is updated
+	offset = static_cast<uint32_t>(header.stringTableSize);
+	const QByteArray bytes = utf8 + '\0';
+	if (!file.seek(static_cast<qint64>(header.stringTableOffset + header.stringTableSize)) ||
+	    file.write(bytes) != bytes.size()) {
+		return false;
+	}
+	header.stringTableSize += static_cast<uint64_t>(bytes.size());
+	stringOffsets.insert(utf8, offset);
+	return true;
+}
+
+bool ChapterIndexWriter::growRecords()
+{
+	// Moving the string table is rare and amortised, capacity doubles each time
+	const uint64_t oldStringTableOffset = header.stringTableOffset;
+	const uint32_t newCapacity = header.recordCapacity * 2;
+	const uint64_t newStringTableOffset = header.recordsOffset + static_cast<uint64_t>(newCapacity) * header.recordSize;
+
+	if (!file.seek(static_cast<qint64>(oldStringTableOffset))) {
+		return false;
+	}
+	const QByteArray strings = file.read(static_cast<qint64>(header.stringTableSize));
+	if (strings.size() != static_cast<qsizetype>(header.stringTableSize) || !file.seek(static_cast<qint64>(newStringTableOffset)) ||
+	    file.write(strings) != strings.size()) {
+		return false;
+	}
+
+	header.recordCapacity = newCapacity;
+	header.stringTableOffset = newStringTableOffset;
+	if (!writeHeader()) {
+		return false;
+	}
+
+	// The old string table area becomes the new empty record slots
+	const QByteArray zeros(static_cast<qsizetype>(newStringTableOffset - oldStringTableOffset), '\0');
+	return file.seek(static_cast<qint64>(oldStringTableOffset)) && file.write(zeros) == zeros.size();
+}
+
+bool ChapterIndexWriter::writeHeader()
+{
+	const QByteArray bytes = ChapterIndex::encodeHeader(header);
+	return file.seek(0) && file.write(bytes) == bytes.size();
+}
+
+bool ChapterIndexWriter::writeRecord(uint32_t index, const ChapterIndex::Record &record)
+{
+	const QByteArray bytes = ChapterIndex::encodeRecord(record);
+	const qint64 offset = static_cast<qint64>(header.recordsOffset + static_cast<uint64_t>(index) * header.recordSize);
+	return file.seek(offset) && file.write(bytes) == bytes.size();
+}
+
+bool ChapterIndexReader::open(const QString &filePath)
+{
+	close();
+	error.clear();
+
+	file.setFileName(filePath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		error = file.errorString();
+		return false;
+	}
+
+	const qint64 size = file.size();
+	data = size > 0 ? file.map(0, size) : nullptr;
+	if (!ChapterIndex::readHeader(data, size, indexHeader)) {
+		error = "Not a chapter index or unsupported version";
+		close();
+		return false;
+	}
+	return true;
+}
+
+void ChapterIndexReader::close()
+{
+	// Closing the file also removes the mapping
+	file.close();
+	data = nullptr;
+	indexHeader = {};
+}
+
+QString ChapterIndexReader::string(uint32_t offset, uint32_t length) const
+{
+	if (!data || static_cast<uint64_t>(offset) + length > indexHeader.stringTableSize) {
+		return QString();
+	}
+	return QString::fromUtf8(reinterpret_cast<const char *>(data + indexHeader.stringTableOffset + offset),
+				 static_cast<qsizetype>(length));
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#ifndef CHAPTER_INDEX_HPP
+#define CHAPTER_INDEX_HPP
+
+#include "timecode-format.hpp"
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Binary chapter index sidecar, version 2
+ *
+ * Layout, all integers little-endian:
+ *   Header       fixed size, at offset 0
+ *   Records      recordCapacity slots of fixed size at recordsOffset, the
+ *                first recordCount are valid and sorted by frame offset
+ *   String table NUL-terminated UTF-8 at stringTableOffset, each distinct
+ *                string is stored once
+ *
+ * The file is written live. Strings and the record land first and the header
+ * counts are updated last, so a reader that maps the file and trusts the
+ * header never sees a half-written record. When the record slots run out the
+ * string table is moved behind a doubled record area. Readers must use
+ * headerSize, recordSize and the offsets from the header rather than the
+ * sizes below, later versions may grow both.
+ *
+ * Version 2 adds the session anchor at the end of the header: the monotonic
+ * (os_gettime_ns) and wall-clock time of frame 0, so sessions recorded by
+ * several OBS instances can be lined up afterwards. Version 1 files read
+ * with both anchors set to 0.
+ */
+namespace ChapterIndex {
+
+constexpr char MAGIC[8] = {'S', 'U', 'C', 'H', 'I', 'D', 'X', '\0'};
+constexpr uint16_t VERSION = 2;
+constexpr uint16_t HEADER_SIZE_V1 = 64;
+constexpr uint32_t NO_MARKER_ID = UINT32_MAX;
+
+enum HeaderFlags : uint16_t {
+	HeaderComplete = 1 << 0, // Set when the recording stopped and the file was closed
+};
+
+enum RecordFlags : uint8_t {
+	RecordDeleted = 1 << 0,    // Removed during the recording, kept so the order stays intact
+	RecordAnnotation = 1 << 1, // Name is the annotation title, the body is in the annotation store
+};
+
+struct Header {
+	char magic[8];
+	uint16_t version;
+	uint16_t headerSize;
+	uint16_t recordSize;
+	uint16_t flags;
+	uint32_t fpsNum;
+	uint32_t fpsDen;
+	uint64_t recordsOffset;
+	uint32_t recordCapacity;
+	uint32_t recordCount;
+	uint64_t stringTableOffset;
+	uint64_t stringTableSize;
+	uint64_t reserved;
+	uint64_t startMonotonicNs; // Version 2
+	int64_t startWallClockNs; // Nanoseconds since the Unix epoch, version 2
+};
+
+struct SessionAnchor {
+	uint64_t monotonicNs = 0;
+	int64_t wallClockNs = 0;
+};
+
+struct Record {
+	uint64_t frameOffset;
+	uint32_t nameOffset; // Relative to the string table
+	uint32_t nameLength; // Bytes, without the NUL
+	uint32_t sourceOffset;
+	uint32_t sourceLength;
+	uint8_t sourceKind; // MarkerSource::Kind
+	uint8_t flags;
+	uint16_t reserved;
+	uint32_t markerId;
+};
+
+static_assert(sizeof(Header) == 80 && offsetof(Header, recordsOffset) == 24 && offsetof(Header, stringTableSize) == 48 &&
+		      offsetof(Header, startMonotonicNs) == HEADER_SIZE_V1,
+	      "Chapter index header layout changed");
+static_assert(sizeof(Record) == 32 && offsetof(Record, sourceKind) == 24 && offsetof(Record, markerId) == 28,
+	      "Chapter index record layout changed");
+
+// Checks the magic, version and sizes and converts the header to host order
+bool readHeader(const uchar *data, qint64 size, Header &out);
+Record readRecord(const uchar *data, const Header &header, uint32_t index);
+
+// First record at or after the frame, header.recordCount if there is none
+uint32_t lowerBound(const uchar *data, const Header &header, uint64_t frameOffset);
+
+} // namespace ChapterIndex
+
+/**
+ * @class ChapterIndexWriter
+ * @brief Appends markers to a binary chapter index while recording
+ *
+ * The file stays open for the whole recording and every change is flushed,
+ * so tools can map it while OBS is still writing. Records are addressed by
+ * the dock's marker id for renames and deletes, which patch the record in
+ * place. Only depends on Qt Core, failures are returned for the caller to log.
+ */
+class ChapterIndexWriter {
+public:
+	static constexpr uint32_t INITIAL_CAPACITY = 256;
+
+	bool create(const QString &filePath, const Timecode::Timebase &timebase, const ChapterIndex::SessionAnchor &anchor);
+	void close();
+	bool isOpen() const { return file.isOpen(); }
+	QString path() const { return file.fileName(); }
+
+	bool append(uint64_t frameOffset, uint32_t markerId, uint8_t sourceKind, uint8_t flags, const QString &name,
+		    const QString &source);
+	bool renameMarker(uint32_t markerId, const QString &name);
+	bool markDeleted(uint32_t markerId);
+
+private:
+	bool addString(const QString &text, uint32_t &offset, uint32_t &length);
+	bool growRecords();
+	bool writeHeader();
+	bool writeRecord(uint32_t index, const ChapterIndex::Record &record);
+
+	QFile file;
+	ChapterIndex::Header header = {};
+	QHash<QByteArray, uint32_t> stringOffsets;
+	QHash<uint32_t, uint32_t> recordIndexByMarker;
+	QVector<ChapterIndex::Record> records; // Host order copy, patched and written back on edits
+};
+
+/**
+ * @class ChapterIndexReader
+ * @brief Maps a chapter index and decodes its records on demand
+ *
+ * Used by the offline tools. The mapping stays valid until close(), so many
+ * files can be open at once without reading them into memory.
+ */
+class ChapterIndexReader {
+public:
+	bool open(const QString &filePath);
+	void close();
+	QString path() const { return file.fileName(); }
+	const QString &errorString() const { return error; }
+
+	const ChapterIndex::Header &header() const { return indexHeader; }
+	bool isComplete() const { return (indexHeader.flags & ChapterIndex::HeaderComplete) != 0; }
+	Timecode::Timebase timebase() const { return {indexHeader.fpsNum, indexHeader.fpsDen}; }
+	ChapterIndex::SessionAnchor anchor() const { return {indexHeader.startMonotonicNs, indexHeader.startWallClockNs}; }
+
+	uint32_t recordCount() const { return indexHeader.recordCount; }
+	ChapterIndex::Record record(uint32_t index) const { return ChapterIndex::readRecord(data, indexHeader, index); }
+	// Empty when the range lies outside the string table
+	QString string(uint32_t offset, uint32_t length) const;
+
+private:
+	QFile file;
+	const uchar *data = nullptr;
+	ChapterIndex::Header indexHeader = {};
+	QString error;
+};
+
+#endif // CHAPTER_INDEX_HPP
@@ -1,34 +1,59 @@
 #include "chapter-marker-dock.hpp"
 #include "annotation-dock.hpp"
+#include "chapter-export.hpp"
 #include "constants.hpp"
+#include "file-relocate.hpp"
 #include "streamup-record-chapter-manager.hpp"
+#include "text-escape.hpp"
 #include "version.h"
 #include <obs-data.h>
 #include <obs-frontend-api.h>
 #include <obs-module.h>
+#include <util/platform.h>
 #include <QApplication>
+#include <QAtomicInteger>
 #include <QCheckBox>
 #include <QComboBox>
+#include <QDate>
+#include <QDateTime>
 #include <QDesktopServices>
 #include <QDialogButtonBox>
 #include <QDir>
+#include <QDirIterator>
 #include <QDockWidget>
+#include <QElapsedTimer>
+#include <QFileDialog>
 #include <QFile>
+#include <QFileInfo>
+#include <QFormLayout>
 #include <QFrame>
 #include <QGroupBox>
 #include <QHBoxLayout>
+#include <QInputDialog>
 #include <QListWidget>
 #include <QMainWindow>
-#include <QMessageBox>
+#include <QMenu>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QPlainTextEdit>
+#include <QRunnable>
 #include <QStyle>
 #include <QTextStream>
+#include <QUrl>
+#include <QUuid>
 #include <QVBoxLayout>
+#include <algorithm>
+#include <chrono>
+#include <memory>
 
 #define QT_TO_UTF8(str) str.toUtf8().constData()
 
 extern void AddChapterMarkerHotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
 QString currentChapterName;
 
+using ChapterExport::appendEscaped;
+
 //--------------------CONSTRUCTOR & DESTRUCTOR--------------------
 ChapterMarkerDock::ChapterMarkerDock(QWidget *parent)
 	: QFrame(parent),
@@ -37,14 +62,24 @@ ChapterMarkerDock::ChapterMarkerDock(QWidget *parent)
 	  exportChaptersToFCPXMLEnabled(false),
 	  exportChaptersToPremiereXMLEnabled(false),
 	  exportChaptersToEDLEnabled(false),
+	  exportChaptersToIndexEnabled(false),
+	  exportChaptersToJsonLinesEnabled(false),
+	  stageExportFilesEnabled(false),
+	  exportChaptersToTemplateEnabled(false),
 	  exportChaptersToFileEnabled(false),
 	  insertChapterMarkersInVideoEnabled(false),
+	  deferInContainerChaptersEnabled(false),
+	  inContainerChaptersSupported(false),
 	  exportTextFilePath(""),
 	  exportFCPXMLFilePath(""),
 	  exportPremiereXMLFilePath(""),
 	  exportEDLFilePath(""),
+	  exportTemplateFilePath(""),
 	  defaultChapterName(obs_module_text("DefaultChapterName")),
+	  chapterNameTemplateSource(Constants::DEFAULT_CHAPTER_NAME_TEMPLATE),
+	  sceneChapterNameTemplateSource(Constants::DEFAULT_SCENE_CHAPTER_NAME_TEMPLATE),
 	  edlEventNumber(1),
+	  edlPartNumber(1),
 	  fcpMarkerID(1),
 	  ignoredScenes(),
 	  chapterOnSceneChangeEnabled(false),
@@ -58,6 +93,8 @@ ChapterMarkerDock::ChapterMarkerDock(QWidget *parent)
 	  presetChapters(),
 	  chapterHotkeys(),
 	  presetChaptersDialog(nullptr),
+	  searchRecordingsButton(nullptr),
+	  webhooksButton(nullptr),
 	  presetChapterNameInput(nullptr),
 	  addChapterButton(nullptr),
 	  removeChapterButton(nullptr),
@@ -67,8 +104,22 @@ ChapterMarkerDock::ChapterMarkerDock(QWidget *parent)
 	  exportChaptersToFCPXMLCheckbox(nullptr),
 	  exportChaptersToPremiereXMLCheckbox(nullptr),
 	  exportChaptersToEDLCheckbox(nullptr),
+	  exportChaptersToIndexCheckbox(nullptr),
+	  exportChaptersToJsonLinesCheckbox(nullptr),
+	  jsonLinesDurabilityCombo(nullptr),
+	  jsonLinesSyncEverySpinBox(nullptr),
+	  stageExportFilesCheckbox(nullptr),
+	  exportStagingDirectoryEdit(nullptr),
+	  exportStagingBrowseButton(nullptr),
+	  exportChaptersToTemplateCheckbox(nullptr),
+	  editExportTemplateButton(nullptr),
 	  exportSettingsGroup(nullptr),
 	  insertChapterMarkersCheckbox(nullptr),
+	  deferInContainerChaptersCheckbox(nullptr),
+	  deferInContainerChaptersLayout(nullptr),
+	  chapterTargetsLabel(nullptr),
+	  chapterTargetsEdit(nullptr),
+	  chapterTargetsLayout(nullptr),
 	  ignoredScenesDialog(nullptr),
 	  sceneChangeSettingsGroup(nullptr),
 	  chapterNameInput(new QLineEdit(this)),
@@ -83,20 +134,70 @@ ChapterMarkerDock::ChapterMarkerDock(QWidget *parent)
 	  previousChaptersGroup(nullptr),
 	  saveChapterMarkerButton(new QPushButton(obs_module_text("SaveChapterMarkerButton"), this)),
 	  defaultChapterNameEdit(nullptr),
+	  chapterNameTemplateEdit(nullptr),
+	  sceneChapterNameTemplateEdit(nullptr),
 	  showPreviousChaptersCheckbox(nullptr),
 	  fullChapterHistoryCheckbox(nullptr),
 	  addChapterSourceCheckbox(nullptr),
 	  chapterOnSceneChangeCheckbox(nullptr),
 	  ignoredScenesListWidget(nullptr),
 	  ignoredScenesGroup(nullptr),
-	  chapters(),
-	  timestamps(),
+	  sessionStrings(),
+	  fullChapterNameIds(),
+	  sessionMarkers(),
+	  lastWrittenFrameOffset(0),
+	  jsonLinesDurability(JsonLinesSidecar::Durability::Interval),
+	  jsonLinesSyncEvery(Constants::DEFAULT_JSON_LINES_SYNC_INTERVAL_MS),
 	  textCheckboxLayout(nullptr),
 	  fcpXmlCheckboxLayout(nullptr),
 	  premiereXmlCheckboxLayout(nullptr),
 	  edlCheckboxLayout(nullptr),
-	  exportSettingsLayout(nullptr)
-{
+	  indexCheckboxLayout(nullptr),
+	  jsonLinesCheckboxLayout(nullptr),
+	  stagingLayout(nullptr),
+	  templateCheckboxLayout(nullptr),
+	  exportSettingsLayout(nullptr),
+	  exportTemplateDialog(nullptr),
+	  webhooksDialog(nullptr),
+	  templateMarkerIndex(1),
+	  recordingSearchDialog(nullptr),
+	  recordingSearchEdit(nullptr),
+	  recordingSearchResults(nullptr),
+	  recordingSearchStatusLabel(nullptr),
+	  recordingSearchIndexButton(nullptr),
+	  oscListenerEnabled(false),
+	  oscListenerPort(Constants::DEFAULT_OSC_PORT),
+	  oscListenerCheckbox(nullptr),
+	  oscListenerPortSpinBox(nullptr),
+	  oscListenerAllInterfaces(false),
+	  oscListenerAllInterfacesCheckbox(nullptr),
+	  eventFeedEnabled(false),
+	  eventFeedCheckbox(nullptr),
+	  chapterOnSilenceEnabled(false),
+	  silenceThresholdDb(Constants::DEFAULT_SILENCE_THRESHOLD_DB),
+	  silenceMinSeconds(Constants::DEFAULT_SILENCE_MIN_SECONDS),
+	  chapterOnSilenceCheckbox(nullptr),
+	  silenceSourceCombo(nullptr),
+	  silenceThresholdSpinBox(nullptr),
+	  silenceMinSecondsSpinBox(nullptr)
+{
+	// Finalizing files at stop must not compete with the encoder or the UI
+	finalizePool.setThreadPriority(QThread::LowPriority);
+	finalizePool.setMaxThreadCount(Constants::FINALIZE_MAX_THREADS);
+	catalogPool.setThreadPriority(QThread::LowPriority);
+	openSessionCatalog();
+
+	if (!chapterState.open(Constants::CHAPTER_STATE_KEY)) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Not publishing the shared chapter state: %s",
+		     QT_TO_UTF8(chapterState.errorString()));
+	}
+
+	char *webhookSpoolPath = obs_module_config_path(Constants::WEBHOOK_SPOOL_FILE_NAME);
+	if (webhookSpoolPath) {
+		webhookSender.setSpoolPath(QString::fromUtf8(webhookSpoolPath));
+		bfree(webhookSpoolPath);
+	}
+
 	// UI Setup
 	setupMainDockUI();
 	// Signal Connections
@@ -109,6 +210,18 @@ ChapterMarkerDock::ChapterMarkerDock(QWidget *parent)
 
 ChapterMarkerDock::~ChapterMarkerDock()
 {
+	// The audio callback points at this dock's detector
+	silenceDetector.detach();
+	// Files from the last recording are still being finished, they report back to this dock
+	finalizePool.waitForDone();
+	// A backfill still queued is dropped, the folder can be scanned again later
+	catalogPool.clear();
+	catalogPool.waitForDone();
+	// Webhook events that were not delivered yet are written to the spool
+	webhookSender.stop();
+	oscListener.stopListening();
+	eventFeed.stop();
+
 	for (const auto &chapterName : chapterHotkeys.keys()) {
 		unregisterChapterHotkey(chapterName);
 	}
@@ -119,6 +232,15 @@ ChapterMarkerDock::~ChapterMarkerDock()
 	if (ignoredScenesDialog) {
 		delete ignoredScenesDialog;
 	}
+	if (exportTemplateDialog) {
+		delete exportTemplateDialog;
+	}
+	if (webhooksDialog) {
+		delete webhooksDialog;
+	}
+	if (recordingSearchDialog) {
+		delete recordingSearchDialog;
+	}
 }
 
 //--------------------SIGNAL CONNECTIONS--------------------
@@ -130,6 +252,22 @@ void ChapterMarkerDock::setupConnections()
 	// Websocket add chapter
 	connect(this, &ChapterMarkerDock::addChapterMarkerSignal, this, &ChapterMarkerDock::onAddChapterMarker);
 
+	// Websocket chapter edits
+	connect(this, &ChapterMarkerDock::renameChapterMarkerSignal, this, &ChapterMarkerDock::onRenameChapterMarker);
+	connect(this, &ChapterMarkerDock::deleteChapterMarkerSignal, this, &ChapterMarkerDock::onDeleteChapterMarker);
+	connect(this, &ChapterMarkerDock::undoLastChapterMarkerSignal, this, &ChapterMarkerDock::onUndoLastChapterMarker);
+
+	// Interval durability, records written in a burst are synced here once it is over
+	connect(&jsonLinesSyncTimer, &QTimer::timeout, this, [this]() { jsonLinesSidecar.syncIfDue(); });
+
+	// Speech onsets after a silence, collected from the audio thread
+	connect(&silenceOnsetTimer, &QTimer::timeout, this, &ChapterMarkerDock::onSilenceOnsetTimer);
+
+	// OSC cues, queued from the listener thread
+	connect(&oscListener, &OscListener::chapterReceived, this, &ChapterMarkerDock::onOscChapterReceived);
+	connect(&oscListener, &OscListener::annotationReceived, this, &ChapterMarkerDock::onOscAnnotationReceived);
+	connect(&oscListener, &OscListener::presetChapterReceived, this, &ChapterMarkerDock::onOscPresetChapterReceived);
+
 	// Enter Chapter Name text field and button
 	connect(chapterNameInput, &QLineEdit::returnPressed, saveChapterMarkerButton, &QPushButton::click);
 	connect(saveChapterMarkerButton, &QPushButton::clicked, this, &ChapterMarkerDock::onAddChapterMarkerButton);
@@ -143,6 +281,9 @@ void ChapterMarkerDock::setupConnections()
 	// Previous Chapter list
 	connect(previousChaptersList, &QListWidget::itemClicked, this, &ChapterMarkerDock::onPreviousChapterSelected);
 	connect(previousChaptersList, &QListWidget::itemDoubleClicked, this, &ChapterMarkerDock::onPreviousChapterDoubleClicked);
+	previousChaptersList->setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(previousChaptersList, &QListWidget::customContextMenuRequested, this,
+		&ChapterMarkerDock::onPreviousChaptersContextMenu);
 
 	// Feedback label timer
 	feedbackTimer.setInterval(Constants::FEEDBACK_TIMER_INTERVAL);
@@ -309,18 +450,13 @@ void ChapterMarkerDock::onAddChapterMarkerButton()
 		return;
 	}
 
-	QString chapterName = getChapterName();
+	const QString chapterName = getChapterName();
 	if (chapterName.isEmpty()) {
 		// Use the default chapter name if the user did not provide one
-		if (useIncrementalChapterNames) {
-			chapterName = defaultChapterName + " " + QString::number(chapterCount);
-			chapterCount++;
-		} else {
-			chapterName = defaultChapterName;
-		}
+		addChapterMarker(formatDefaultChapterName(useIncrementalChapterNames), MarkerSource::Kind::Manual);
+	} else {
+		addChapterMarker(chapterName, MarkerSource::Kind::Manual);
 	}
-
-	addChapterMarker(chapterName, obs_module_text("SourceManual"));
 	chapterNameInput->clear();
 }
 
@@ -334,8 +470,14 @@ void ChapterMarkerDock::onSettingsClicked()
 
 void ChapterMarkerDock::onRecordingStopped()
 {
+	silenceOnsetTimer.stop();
+	silenceDetector.detach();
+
 	if (!exportChaptersToFileEnabled && !insertChapterMarkersInVideoEnabled) {
 		showFeedbackMessage(obs_module_text("NoExportMethod"), true);
+		chapterIndex.close();
+		resetExportFiles();
+		clearSession();
 		return;
 	}
 
@@ -346,19 +488,54 @@ void ChapterMarkerDock::onRecordingStopped()
 
 	showFeedbackMessage(obs_module_text("RecordingFinished"), false);
 
-	QString timestamp = getCurrentRecordingTime();
-	writeChapterToTextFile(obs_module_text("End"), timestamp, obs_module_text("Recording"));
+	// Everything that reads session state is rendered here, only the file writes go to the pool
+	QVector<FinalizeTask> finalizeTasks;
+	const uint64_t endFrame = getCurrentRecordingFrame();
+	if (exportChaptersToFileEnabled && exportChaptersToTextEnabled && !exportTextFilePath.isEmpty()) {
+		const QByteArray endLine = formatTextMarker(obs_module_text("End"), endFrame, MarkerSource::Kind::Recording);
+		finalizeTasks.append(
+			{"text", exportTextFilePath, [sidecar = textSidecar, endLine]() mutable { return sidecar.append(endLine); }});
+	}
 
-	// Close XML files with proper closing tags
+	// The XML footers are already on disk
 	closeFCPXMLFile();
 	closePremiereXMLFile();
+	appendFinalizeTask(finalizeTasks, closeTemplateFile(endFrame));
+	chapterIndex.close();
+	jsonLinesSyncTimer.stop();
+	jsonLinesSidecar.close(endFrame);
+
+	// Flush chapters the container could not take
+	appendFinalizeTask(finalizeTasks, finalizeDeferredChaptersFile());
+
+	if (!activeStagingDirectory.isEmpty()) {
+		appendStagedFileMoves(finalizeTasks);
+	}
+	resetExportFiles();
+
+	startFinalizeTasks(finalizeTasks);
+	addSessionToCatalog();
+	chapterFanout.stop();
+
+	// Clients and scripts hear the session is over before its state is cleared
+	const auto liveMarkerCount = std::count_if(sessionMarkers.cbegin(), sessionMarkers.cend(),
+						   [](const SessionMarker &marker) { return !marker.deleted; });
+	char *recordingPath = obs_frontend_get_last_recording();
+	obs_data_t *event_data = obs_data_create();
+	obs_data_set_string(event_data, "recordingPath", recordingPath ? recordingPath : "");
+	obs_data_set_int(event_data, "chapterCount", static_cast<long long>(liveMarkerCount));
+	EmitChapterEvent("ChapterSessionStopped", event_data);
+	obs_data_release(event_data);
+	bfree(recordingPath);
 
 	clearPreviousChaptersGroup();
+	clearSession();
 	blog(LOG_INFO, "[StreamUP Record Chapter Manager] chapterCount: %d", chapterCount);
 
-	incompatibleFileTypeMessageShown = false;
 	chapterCount = Constants::DEFAULT_CHAPTER_COUNT; // Reset chapter count
 	edlEventNumber = 1; // Reset EDL event number for next recording
+	edlPartNumber = 1;
+	finishedEdlSidecars.clear();
 	fcpMarkerID = 1; // Reset FCP marker ID for next recording
 }
 
@@ -378,11 +555,40 @@ void ChapterMarkerDock::onPreviousChapterDoubleClicked(QListWidgetItem *item)
 	}
 }
 
+void ChapterMarkerDock::onPreviousChaptersContextMenu(const QPoint &position)
+{
+	QListWidgetItem *item = previousChaptersList->itemAt(position);
+	const int markerId = item ? item->data(Qt::UserRole).toInt() : -1;
+	const bool editable = item && obs_frontend_recording_active() && markerId >= 0 && markerId < sessionMarkers.size();
+
+	QMenu menu(this);
+	QAction *renameAction = menu.addAction(obs_module_text("RenameChapter"));
+	QAction *deleteAction = menu.addAction(obs_module_text("DeleteChapter"));
+	menu.addSeparator();
+	QAction *undoAction = menu.addAction(obs_module_text("UndoLastChapter"));
+	renameAction->setEnabled(editable);
+	deleteAction->setEnabled(editable);
+	undoAction->setEnabled(obs_frontend_recording_active() && lastLiveMarkerId() >= 0);
+
+	QAction *chosen = menu.exec(previousChaptersList->viewport()->mapToGlobal(position));
+	if (chosen == renameAction) {
+		bool ok = false;
+		const QString chapterName = QInputDialog::getText(this, obs_module_text("RenameChapter"),
+								  obs_module_text("RenameChapterPrompt"), QLineEdit::Normal,
+								  sessionStrings.text(sessionMarkers.at(markerId).name), &ok);
+		if (ok) {
+			onRenameChapterMarker(markerId, chapterName);
+		}
+	} else if (chosen == deleteAction) {
+		onDeleteChapterMarker(markerId);
+	} else if (chosen == undoAction) {
+		onUndoLastChapterMarker();
+	}
+}
+
 void ChapterMarkerDock::clearPreviousChaptersGroup()
 {
 	previousChaptersList->clear();
-	chapters.clear();
-	timestamps.clear();
 }
 
 void ChapterMarkerDock::loadAnnotationDock()
@@ -532,6 +738,20 @@ void ChapterMarkerDock::setupSettingsGeneralGroup(QVBoxLayout *mainLayout)
 	// Add the horizontal layout to the general settings layout
 	generalSettingsLayout->addLayout(chapterNameLayout);
 
+	QLabel *chapterNameTemplateLabel = new QLabel(obs_module_text("GeneralSettingsChapterNameTemplate"), generalSettingsGroup);
+	chapterNameTemplateLabel->setToolTip(obs_module_text("ChapterNameTemplateTooltip"));
+
+	chapterNameTemplateEdit = new QLineEdit(generalSettingsGroup);
+	chapterNameTemplateEdit->setPlaceholderText(Constants::DEFAULT_CHAPTER_NAME_TEMPLATE);
+	chapterNameTemplateEdit->setToolTip(obs_module_text("ChapterNameTemplateTooltip"));
+	chapterNameTemplateEdit->setText(chapterNameTemplateSource);
+	chapterNameTemplateEdit->setMinimumWidth(200);
+
+	QHBoxLayout *chapterNameTemplateLayout = new QHBoxLayout;
+	chapterNameTemplateLayout->addWidget(chapterNameTemplateLabel);
+	chapterNameTemplateLayout->addWidget(chapterNameTemplateEdit);
+	generalSettingsLayout->addLayout(chapterNameTemplateLayout);
+
 	QCheckBox *useIncrementalChapterNamesCheckbox =
 		new QCheckBox(obs_module_text("UseIncrementalChapterNames"), generalSettingsGroup);
 	useIncrementalChapterNamesCheckbox->setToolTip(obs_module_text("UseIncrementalChapterNamesTooltip"));
@@ -560,6 +780,43 @@ void ChapterMarkerDock::setupSettingsGeneralGroup(QVBoxLayout *mainLayout)
 	connect(setPresetChaptersButton, &QPushButton::clicked, this, &ChapterMarkerDock::onSetPresetChaptersButtonClicked);
 	generalSettingsLayout->addWidget(setPresetChaptersButton);
 
+	searchRecordingsButton = new QPushButton(obs_module_text("GeneralSettingsSearchRecordings"), generalSettingsGroup);
+	searchRecordingsButton->setToolTip(obs_module_text("GeneralSettingsSearchRecordingsTooltip"));
+	connect(searchRecordingsButton, &QPushButton::clicked, this, &ChapterMarkerDock::onSearchRecordingsClicked);
+	generalSettingsLayout->addWidget(searchRecordingsButton);
+
+	webhooksButton = new QPushButton(obs_module_text("GeneralSettingsWebhooks"), generalSettingsGroup);
+	webhooksButton->setToolTip(obs_module_text("GeneralSettingsWebhooksTooltip"));
+	connect(webhooksButton, &QPushButton::clicked, this, &ChapterMarkerDock::onEditWebhooksClicked);
+	generalSettingsLayout->addWidget(webhooksButton);
+
+	// The listener thread only runs while this is on
+	oscListenerCheckbox = new QCheckBox(obs_module_text("GeneralSettingsOscListener"), generalSettingsGroup);
+	oscListenerCheckbox->setToolTip(obs_module_text("GeneralSettingsOscListenerTooltip"));
+	oscListenerCheckbox->setChecked(oscListenerEnabled);
+	oscListenerPortSpinBox = new QSpinBox(generalSettingsGroup);
+	oscListenerPortSpinBox->setRange(1, 65535);
+	oscListenerPortSpinBox->setValue(oscListenerPort);
+	oscListenerPortSpinBox->setEnabled(oscListenerEnabled);
+	connect(oscListenerCheckbox, &QCheckBox::toggled, oscListenerPortSpinBox, &QSpinBox::setEnabled);
+	oscListenerAllInterfacesCheckbox =
+		new QCheckBox(obs_module_text("GeneralSettingsOscListenerAllInterfaces"), generalSettingsGroup);
+	oscListenerAllInterfacesCheckbox->setToolTip(obs_module_text("GeneralSettingsOscListenerAllInterfacesTooltip"));
+	oscListenerAllInterfacesCheckbox->setChecked(oscListenerAllInterfaces);
+	oscListenerAllInterfacesCheckbox->setEnabled(oscListenerEnabled);
+	connect(oscListenerCheckbox, &QCheckBox::toggled, oscListenerAllInterfacesCheckbox, &QCheckBox::setEnabled);
+	QHBoxLayout *oscListenerLayout = new QHBoxLayout;
+	oscListenerLayout->addWidget(oscListenerCheckbox);
+	oscListenerLayout->addWidget(oscListenerPortSpinBox);
+	oscListenerLayout->addWidget(oscListenerAllInterfacesCheckbox);
+	oscListenerLayout->addStretch();
+	generalSettingsLayout->addLayout(oscListenerLayout);
+
+	eventFeedCheckbox = new QCheckBox(obs_module_text("GeneralSettingsEventFeed"), generalSettingsGroup);
+	eventFeedCheckbox->setToolTip(QString(obs_module_text("GeneralSettingsEventFeedTooltip")).arg(Constants::EVENT_FEED_SERVER_NAME));
+	eventFeedCheckbox->setChecked(eventFeedEnabled);
+	generalSettingsLayout->addWidget(eventFeedCheckbox);
+
 	generalSettingsGroup->setLayout(generalSettingsLayout);
 	generalSettingsGroup->adjustSize();
 
@@ -579,6 +836,30 @@ void ChapterMarkerDock::setupSettingsExportGroup(QVBoxLayout *mainLayout)
 	insertChapterMarkersCheckbox->setToolTip(obs_module_text("ExportSettingsInsertIntoFileTooltip"));
 	exportSettingsLayout->addWidget(insertChapterMarkersCheckbox);
 	insertChapterMarkersCheckbox->setChecked(insertChapterMarkersInVideoEnabled);
+	connect(insertChapterMarkersCheckbox, &QCheckBox::toggled, this, &ChapterMarkerDock::onInsertChapterMarkersToggled);
+
+	// Defer in-video chapters to a metadata file when the container cannot take them
+	deferInContainerChaptersCheckbox =
+		new QCheckBox(obs_module_text("ExportSettingsDeferInContainerChapters"), exportSettingsGroup);
+	deferInContainerChaptersCheckbox->setToolTip(obs_module_text("ExportSettingsDeferInContainerChaptersTooltip"));
+	deferInContainerChaptersCheckbox->setChecked(deferInContainerChaptersEnabled);
+	deferInContainerChaptersCheckbox->setVisible(insertChapterMarkersInVideoEnabled);
+	deferInContainerChaptersLayout = new QHBoxLayout;
+	deferInContainerChaptersLayout->addSpacing(Constants::INDENT_SPACING);
+	deferInContainerChaptersLayout->addWidget(deferInContainerChaptersCheckbox);
+	exportSettingsLayout->addLayout(deferInContainerChaptersLayout);
+
+	// Procs of other plugins that receive every chapter, Aitum Vertical by default
+	chapterTargetsLabel = new QLabel(obs_module_text("ExportSettingsChapterTargets"), exportSettingsGroup);
+	chapterTargetsEdit = new QLineEdit(chapterFanout.targets().join(", "), exportSettingsGroup);
+	chapterTargetsEdit->setToolTip(obs_module_text("ExportSettingsChapterTargetsTooltip"));
+	chapterTargetsLabel->setVisible(insertChapterMarkersInVideoEnabled);
+	chapterTargetsEdit->setVisible(insertChapterMarkersInVideoEnabled);
+	chapterTargetsLayout = new QHBoxLayout;
+	chapterTargetsLayout->addSpacing(Constants::INDENT_SPACING);
+	chapterTargetsLayout->addWidget(chapterTargetsLabel);
+	chapterTargetsLayout->addWidget(chapterTargetsEdit);
+	exportSettingsLayout->addLayout(chapterTargetsLayout);
 
 	// Create check boxes
 	exportChaptersToFileCheckbox = new QCheckBox(obs_module_text("ExportSettingsExportToFile"), exportSettingsGroup);
@@ -591,6 +872,54 @@ void ChapterMarkerDock::setupSettingsExportGroup(QVBoxLayout *mainLayout)
 	exportChaptersToPremiereXMLCheckbox->setToolTip(obs_module_text("ExportSettingsExportToPremiereXmlTooltip"));
 	exportChaptersToEDLCheckbox = new QCheckBox(obs_module_text("ExportSettingsExportToEDL"), exportSettingsGroup);
 	exportChaptersToEDLCheckbox->setToolTip(obs_module_text("ExportSettingsExportToEDLTooltip"));
+	exportChaptersToIndexCheckbox = new QCheckBox(obs_module_text("ExportSettingsExportToIndex"), exportSettingsGroup);
+	exportChaptersToIndexCheckbox->setToolTip(obs_module_text("ExportSettingsExportToIndexTooltip"));
+	exportChaptersToJsonLinesCheckbox = new QCheckBox(obs_module_text("ExportSettingsExportToJsonLines"), exportSettingsGroup);
+	exportChaptersToJsonLinesCheckbox->setToolTip(obs_module_text("ExportSettingsExportToJsonLinesTooltip"));
+	jsonLinesDurabilityCombo = new QComboBox(exportSettingsGroup);
+	jsonLinesDurabilityCombo->setToolTip(obs_module_text("ExportSettingsJsonLinesSyncTooltip"));
+	jsonLinesDurabilityCombo->addItem(obs_module_text("ExportSettingsJsonLinesSyncNone"),
+					  static_cast<int>(JsonLinesSidecar::Durability::None));
+	jsonLinesDurabilityCombo->addItem(obs_module_text("ExportSettingsJsonLinesSyncRecords"),
+					  static_cast<int>(JsonLinesSidecar::Durability::EveryRecords));
+	jsonLinesDurabilityCombo->addItem(obs_module_text("ExportSettingsJsonLinesSyncInterval"),
+					  static_cast<int>(JsonLinesSidecar::Durability::Interval));
+	jsonLinesSyncEverySpinBox = new QSpinBox(exportSettingsGroup);
+	jsonLinesSyncEverySpinBox->setToolTip(obs_module_text("ExportSettingsJsonLinesSyncTooltip"));
+	jsonLinesSyncEverySpinBox->setRange(1, Constants::MAX_JSON_LINES_SYNC_EVERY);
+	// The count means records or milliseconds, switching starts from that policy's default
+	connect(jsonLinesDurabilityCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+		const auto durability = static_cast<JsonLinesSidecar::Durability>(jsonLinesDurabilityCombo->itemData(index).toInt());
+		jsonLinesSyncEverySpinBox->setEnabled(durability != JsonLinesSidecar::Durability::None);
+		if (durability == JsonLinesSidecar::Durability::EveryRecords) {
+			jsonLinesSyncEverySpinBox->setValue(durability == jsonLinesDurability ? jsonLinesSyncEvery
+											       : Constants::DEFAULT_JSON_LINES_SYNC_RECORDS);
+		} else if (durability == JsonLinesSidecar::Durability::Interval) {
+			jsonLinesSyncEverySpinBox->setValue(durability == jsonLinesDurability ? jsonLinesSyncEvery
+											       : Constants::DEFAULT_JSON_LINES_SYNC_INTERVAL_MS);
+		}
+	});
+	exportChaptersToTemplateCheckbox = new QCheckBox(obs_module_text("ExportSettingsExportToTemplate"), exportSettingsGroup);
+	exportChaptersToTemplateCheckbox->setToolTip(obs_module_text("ExportSettingsExportToTemplateTooltip"));
+	editExportTemplateButton = new QPushButton(obs_module_text("ExportSettingsEditTemplate"), exportSettingsGroup);
+	editExportTemplateButton->setToolTip(obs_module_text("ExportSettingsEditTemplateTooltip"));
+	connect(editExportTemplateButton, &QPushButton::clicked, this, &ChapterMarkerDock::onEditExportTemplateClicked);
+
+	// Staging folder for the live files, moved next to the recording when it stops
+	stageExportFilesCheckbox = new QCheckBox(obs_module_text("ExportSettingsStageFiles"), exportSettingsGroup);
+	stageExportFilesCheckbox->setToolTip(obs_module_text("ExportSettingsStageFilesTooltip"));
+	exportStagingDirectoryEdit = new QLineEdit(exportStagingDirectory, exportSettingsGroup);
+	exportStagingDirectoryEdit->setToolTip(obs_module_text("ExportSettingsStageFilesTooltip"));
+	exportStagingBrowseButton = new QPushButton(obs_module_text("ExportSettingsStagingBrowse"), exportSettingsGroup);
+	connect(exportStagingBrowseButton, &QPushButton::clicked, this, [this]() {
+		const QString directory = QFileDialog::getExistingDirectory(settingsDialog, obs_module_text("ExportSettingsStagingTitle"),
+									   exportStagingDirectoryEdit->text());
+		if (!directory.isEmpty()) {
+			exportStagingDirectoryEdit->setText(QDir::toNativeSeparators(directory));
+		}
+	});
+	connect(stageExportFilesCheckbox, &QCheckBox::toggled, exportStagingDirectoryEdit, &QLineEdit::setEnabled);
+	connect(stageExportFilesCheckbox, &QCheckBox::toggled, exportStagingBrowseButton, &QPushButton::setEnabled);
 
 	// Set check boxes visually
 	exportChaptersToFileCheckbox->setChecked(exportChaptersToFileEnabled);
@@ -598,10 +927,28 @@ void ChapterMarkerDock::setupSettingsExportGroup(QVBoxLayout *mainLayout)
 	exportChaptersToFCPXMLCheckbox->setChecked(exportChaptersToFCPXMLEnabled);
 	exportChaptersToPremiereXMLCheckbox->setChecked(exportChaptersToPremiereXMLEnabled);
 	exportChaptersToEDLCheckbox->setChecked(exportChaptersToEDLEnabled);
+	exportChaptersToIndexCheckbox->setChecked(exportChaptersToIndexEnabled);
+	exportChaptersToJsonLinesCheckbox->setChecked(exportChaptersToJsonLinesEnabled);
+	jsonLinesSyncEverySpinBox->setValue(jsonLinesSyncEvery);
+	jsonLinesSyncEverySpinBox->setEnabled(jsonLinesDurability != JsonLinesSidecar::Durability::None);
+	jsonLinesDurabilityCombo->setCurrentIndex(jsonLinesDurabilityCombo->findData(static_cast<int>(jsonLinesDurability)));
+	stageExportFilesCheckbox->setChecked(stageExportFilesEnabled);
+	exportStagingDirectoryEdit->setEnabled(stageExportFilesEnabled);
+	exportStagingBrowseButton->setEnabled(stageExportFilesEnabled);
+	exportChaptersToTemplateCheckbox->setChecked(exportChaptersToTemplateEnabled);
 	exportChaptersToTextCheckbox->setVisible(exportChaptersToFileEnabled);
 	exportChaptersToFCPXMLCheckbox->setVisible(exportChaptersToFileEnabled);
 	exportChaptersToPremiereXMLCheckbox->setVisible(exportChaptersToFileEnabled);
 	exportChaptersToEDLCheckbox->setVisible(exportChaptersToFileEnabled);
+	exportChaptersToIndexCheckbox->setVisible(exportChaptersToFileEnabled);
+	exportChaptersToJsonLinesCheckbox->setVisible(exportChaptersToFileEnabled);
+	jsonLinesDurabilityCombo->setVisible(exportChaptersToFileEnabled);
+	jsonLinesSyncEverySpinBox->setVisible(exportChaptersToFileEnabled);
+	stageExportFilesCheckbox->setVisible(exportChaptersToFileEnabled);
+	exportStagingDirectoryEdit->setVisible(exportChaptersToFileEnabled);
+	exportStagingBrowseButton->setVisible(exportChaptersToFileEnabled);
+	exportChaptersToTemplateCheckbox->setVisible(exportChaptersToFileEnabled);
+	editExportTemplateButton->setVisible(exportChaptersToFileEnabled);
 
 	connect(exportChaptersToFileCheckbox, &QCheckBox::toggled, this, &ChapterMarkerDock::onExportChaptersToFileToggled);
 
@@ -611,16 +958,33 @@ void ChapterMarkerDock::setupSettingsExportGroup(QVBoxLayout *mainLayout)
 	fcpXmlCheckboxLayout = new QHBoxLayout;
 	premiereXmlCheckboxLayout = new QHBoxLayout;
 	edlCheckboxLayout = new QHBoxLayout;
+	indexCheckboxLayout = new QHBoxLayout;
+	jsonLinesCheckboxLayout = new QHBoxLayout;
+	stagingLayout = new QHBoxLayout;
+	templateCheckboxLayout = new QHBoxLayout;
 	// Add a spacer to the layouts to create the indent
 	textCheckboxLayout->addSpacing(Constants::INDENT_SPACING);
 	fcpXmlCheckboxLayout->addSpacing(Constants::INDENT_SPACING);
 	premiereXmlCheckboxLayout->addSpacing(Constants::INDENT_SPACING);
 	edlCheckboxLayout->addSpacing(Constants::INDENT_SPACING);
+	indexCheckboxLayout->addSpacing(Constants::INDENT_SPACING);
+	jsonLinesCheckboxLayout->addSpacing(Constants::INDENT_SPACING);
+	stagingLayout->addSpacing(Constants::INDENT_SPACING);
+	templateCheckboxLayout->addSpacing(Constants::INDENT_SPACING);
 	// Add the checkboxes to the layouts
 	textCheckboxLayout->addWidget(exportChaptersToTextCheckbox);
 	fcpXmlCheckboxLayout->addWidget(exportChaptersToFCPXMLCheckbox);
 	premiereXmlCheckboxLayout->addWidget(exportChaptersToPremiereXMLCheckbox);
 	edlCheckboxLayout->addWidget(exportChaptersToEDLCheckbox);
+	indexCheckboxLayout->addWidget(exportChaptersToIndexCheckbox);
+	jsonLinesCheckboxLayout->addWidget(exportChaptersToJsonLinesCheckbox);
+	jsonLinesCheckboxLayout->addWidget(jsonLinesDurabilityCombo);
+	jsonLinesCheckboxLayout->addWidget(jsonLinesSyncEverySpinBox);
+	stagingLayout->addWidget(stageExportFilesCheckbox);
+	stagingLayout->addWidget(exportStagingDirectoryEdit);
+	stagingLayout->addWidget(exportStagingBrowseButton);
+	templateCheckboxLayout->addWidget(exportChaptersToTemplateCheckbox);
+	templateCheckboxLayout->addWidget(editExportTemplateButton);
 
 	// Add the QHBoxLayouts to the main layout
 	if (!exportChaptersToFileEnabled) {
@@ -628,11 +992,19 @@ void ChapterMarkerDock::setupSettingsExportGroup(QVBoxLayout *mainLayout)
 		exportSettingsLayout->removeItem(fcpXmlCheckboxLayout);
 		exportSettingsLayout->removeItem(premiereXmlCheckboxLayout);
 		exportSettingsLayout->removeItem(edlCheckboxLayout);
+		exportSettingsLayout->removeItem(indexCheckboxLayout);
+		exportSettingsLayout->removeItem(jsonLinesCheckboxLayout);
+		exportSettingsLayout->removeItem(templateCheckboxLayout);
+		exportSettingsLayout->removeItem(stagingLayout);
 	} else {
 		exportSettingsLayout->addLayout(textCheckboxLayout);
 		exportSettingsLayout->addLayout(fcpXmlCheckboxLayout);
 		exportSettingsLayout->addLayout(premiereXmlCheckboxLayout);
 		exportSettingsLayout->addLayout(edlCheckboxLayout);
+		exportSettingsLayout->addLayout(indexCheckboxLayout);
+		exportSettingsLayout->addLayout(jsonLinesCheckboxLayout);
+		exportSettingsLayout->addLayout(templateCheckboxLayout);
+		exportSettingsLayout->addLayout(stagingLayout);
 	}
 
 	exportSettingsGroup->setLayout(exportSettingsLayout);
@@ -662,6 +1034,70 @@ void ChapterMarkerDock::setupSettingsAutoChapterGroup(QVBoxLayout *mainLayout)
 	connect(setIgnoredScenesButton, &QPushButton::clicked, this, &ChapterMarkerDock::onSetIgnoredScenesClicked);
 	sceneChangeSettingsLayout->addWidget(setIgnoredScenesButton);
 
+	// Scene chapter name template
+	QLabel *sceneChapterNameTemplateLabel =
+		new QLabel(obs_module_text("AutoChapterSceneNameTemplate"), sceneChangeSettingsGroup);
+	sceneChapterNameTemplateLabel->setToolTip(obs_module_text("AutoChapterSceneNameTemplateTooltip"));
+	sceneChapterNameTemplateEdit = new QLineEdit(sceneChangeSettingsGroup);
+	sceneChapterNameTemplateEdit->setPlaceholderText(Constants::DEFAULT_SCENE_CHAPTER_NAME_TEMPLATE);
+	sceneChapterNameTemplateEdit->setToolTip(obs_module_text("AutoChapterSceneNameTemplateTooltip"));
+	sceneChapterNameTemplateEdit->setText(sceneChapterNameTemplateSource);
+
+	QHBoxLayout *sceneChapterNameTemplateLayout = new QHBoxLayout;
+	sceneChapterNameTemplateLayout->addWidget(sceneChapterNameTemplateLabel);
+	sceneChapterNameTemplateLayout->addWidget(sceneChapterNameTemplateEdit);
+	sceneChangeSettingsLayout->addLayout(sceneChapterNameTemplateLayout);
+
+	// Chapter when speech resumes after a silence on one audio source
+	chapterOnSilenceCheckbox = new QCheckBox(obs_module_text("AutoChapterOnSilence"), sceneChangeSettingsGroup);
+	chapterOnSilenceCheckbox->setToolTip(obs_module_text("AutoChapterOnSilenceTooltip"));
+	chapterOnSilenceCheckbox->setChecked(chapterOnSilenceEnabled);
+	silenceSourceCombo = new QComboBox(sceneChangeSettingsGroup);
+	silenceSourceCombo->setToolTip(obs_module_text("AutoChapterOnSilenceTooltip"));
+	obs_enum_sources(
+		[](void *param, obs_source_t *source) {
+			if (obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO) {
+				static_cast<QComboBox *>(param)->addItem(QString::fromUtf8(obs_source_get_name(source)));
+			}
+			return true;
+		},
+		silenceSourceCombo);
+	// A source that is gone still shows, so saving does not silently switch to another one
+	if (!silenceSourceName.isEmpty() && silenceSourceCombo->findText(silenceSourceName) < 0) {
+		silenceSourceCombo->addItem(silenceSourceName);
+	}
+	silenceSourceCombo->setCurrentIndex(silenceSourceCombo->findText(silenceSourceName));
+	QHBoxLayout *silenceSourceLayout = new QHBoxLayout;
+	silenceSourceLayout->addWidget(chapterOnSilenceCheckbox);
+	silenceSourceLayout->addWidget(silenceSourceCombo);
+	sceneChangeSettingsLayout->addLayout(silenceSourceLayout);
+
+	QLabel *silenceThresholdLabel = new QLabel(obs_module_text("AutoChapterSilenceThreshold"), sceneChangeSettingsGroup);
+	silenceThresholdSpinBox = new QSpinBox(sceneChangeSettingsGroup);
+	silenceThresholdSpinBox->setRange(Constants::MIN_SILENCE_THRESHOLD_DB, -Constants::SILENCE_HYSTERESIS_DB);
+	silenceThresholdSpinBox->setSuffix(" dB");
+	silenceThresholdSpinBox->setValue(silenceThresholdDb);
+	QLabel *silenceMinSecondsLabel = new QLabel(obs_module_text("AutoChapterSilenceLength"), sceneChangeSettingsGroup);
+	silenceMinSecondsSpinBox = new QSpinBox(sceneChangeSettingsGroup);
+	silenceMinSecondsSpinBox->setRange(1, Constants::MAX_SILENCE_MIN_SECONDS);
+	silenceMinSecondsSpinBox->setSuffix(" s");
+	silenceMinSecondsSpinBox->setValue(silenceMinSeconds);
+	QHBoxLayout *silenceLevelLayout = new QHBoxLayout;
+	silenceLevelLayout->addSpacing(Constants::INDENT_SPACING);
+	silenceLevelLayout->addWidget(silenceThresholdLabel);
+	silenceLevelLayout->addWidget(silenceThresholdSpinBox);
+	silenceLevelLayout->addWidget(silenceMinSecondsLabel);
+	silenceLevelLayout->addWidget(silenceMinSecondsSpinBox);
+	silenceLevelLayout->addStretch();
+	sceneChangeSettingsLayout->addLayout(silenceLevelLayout);
+
+	silenceSourceCombo->setEnabled(chapterOnSilenceEnabled);
+	silenceThresholdSpinBox->setEnabled(chapterOnSilenceEnabled);
+	silenceMinSecondsSpinBox->setEnabled(chapterOnSilenceEnabled);
+	connect(chapterOnSilenceCheckbox, &QCheckBox::toggled, silenceSourceCombo, &QComboBox::setEnabled);
+	connect(chapterOnSilenceCheckbox, &QCheckBox::toggled, silenceThresholdSpinBox, &QSpinBox::setEnabled);
+	connect(chapterOnSilenceCheckbox, &QCheckBox::toggled, silenceMinSecondsSpinBox, &QSpinBox::setEnabled);
+
 	sceneChangeSettingsGroup->setLayout(sceneChangeSettingsLayout);
 	sceneChangeSettingsGroup->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
 
@@ -695,17 +1131,34 @@ void ChapterMarkerDock::onExportChaptersToFileToggled(bool checked)
 	exportChaptersToFCPXMLCheckbox->setVisible(checked);
 	exportChaptersToPremiereXMLCheckbox->setVisible(checked);
 	exportChaptersToEDLCheckbox->setVisible(checked);
+	exportChaptersToIndexCheckbox->setVisible(checked);
+	exportChaptersToJsonLinesCheckbox->setVisible(checked);
+	jsonLinesDurabilityCombo->setVisible(checked);
+	jsonLinesSyncEverySpinBox->setVisible(checked);
+	stageExportFilesCheckbox->setVisible(checked);
+	exportStagingDirectoryEdit->setVisible(checked);
+	exportStagingBrowseButton->setVisible(checked);
+	exportChaptersToTemplateCheckbox->setVisible(checked);
+	editExportTemplateButton->setVisible(checked);
 
 	if (!checked) {
 		exportSettingsLayout->removeItem(textCheckboxLayout);
 		exportSettingsLayout->removeItem(fcpXmlCheckboxLayout);
 		exportSettingsLayout->removeItem(premiereXmlCheckboxLayout);
 		exportSettingsLayout->removeItem(edlCheckboxLayout);
+		exportSettingsLayout->removeItem(indexCheckboxLayout);
+		exportSettingsLayout->removeItem(jsonLinesCheckboxLayout);
+		exportSettingsLayout->removeItem(templateCheckboxLayout);
+		exportSettingsLayout->removeItem(stagingLayout);
 	} else {
 		exportSettingsLayout->addLayout(textCheckboxLayout);
 		exportSettingsLayout->addLayout(fcpXmlCheckboxLayout);
 		exportSettingsLayout->addLayout(premiereXmlCheckboxLayout);
 		exportSettingsLayout->addLayout(edlCheckboxLayout);
+		exportSettingsLayout->addLayout(indexCheckboxLayout);
+		exportSettingsLayout->addLayout(jsonLinesCheckboxLayout);
+		exportSettingsLayout->addLayout(templateCheckboxLayout);
+		exportSettingsLayout->addLayout(stagingLayout);
 	}
 
 	QSize size = exportSettingsGroup->sizeHint();
@@ -715,6 +1168,19 @@ void ChapterMarkerDock::onExportChaptersToFileToggled(bool checked)
 	settingsDialog->adjustSize();
 }
 
+void ChapterMarkerDock::onInsertChapterMarkersToggled(bool checked)
+{
+	deferInContainerChaptersCheckbox->setVisible(checked);
+	chapterTargetsLabel->setVisible(checked);
+	chapterTargetsEdit->setVisible(checked);
+
+	QSize size = exportSettingsGroup->sizeHint();
+	int newHeight = size.height();
+	exportSettingsGroup->setFixedHeight(newHeight);
+
+	settingsDialog->adjustSize();
+}
+
 void ChapterMarkerDock::onChapterOnSceneChangeToggled(bool checked)
 {
 	setIgnoredScenesButton->setVisible(checked);
@@ -734,6 +1200,31 @@ void ChapterMarkerDock::onSetIgnoredScenesClicked()
 	ignoredScenesDialog->exec();
 }
 
+void ChapterMarkerDock::onEditExportTemplateClicked()
+{
+	if (!exportTemplateDialog) {
+		exportTemplateDialog = createExportTemplateUI();
+	}
+	exportTemplateDialog->exec();
+}
+
+void ChapterMarkerDock::onEditWebhooksClicked()
+{
+	if (!webhooksDialog) {
+		webhooksDialog = createWebhooksUI();
+	}
+	webhooksDialog->exec();
+}
+
+void ChapterMarkerDock::onSearchRecordingsClicked()
+{
+	if (!recordingSearchDialog) {
+		recordingSearchDialog = createRecordingSearchUI();
+	}
+	updateRecordingSearchResults();
+	recordingSearchDialog->exec();
+}
+
 void ChapterMarkerDock::onSetPresetChaptersButtonClicked()
 {
 	if (!presetChaptersDialog) {
@@ -894,6 +1385,348 @@ void ChapterMarkerDock::LoadPresetChapters(obs_data_t *settings)
 	}
 }
 
+//--------------------EXPORT TEMPLATE UI--------------------
+QDialog *ChapterMarkerDock::createExportTemplateUI()
+{
+	QDialog *dialog = new QDialog(this);
+	dialog->setWindowTitle(obs_module_text("ExportTemplate"));
+
+	QVBoxLayout *mainLayout = new QVBoxLayout(dialog);
+
+	QLabel *explanationLabel = new QLabel(obs_module_text("ExportTemplateExplanation"), dialog);
+	explanationLabel->setWordWrap(true);
+	mainLayout->addWidget(explanationLabel);
+
+	QFormLayout *formLayout = new QFormLayout();
+
+	QLineEdit *suffixEdit = new QLineEdit(exportTemplate.fileSuffix, dialog);
+	suffixEdit->setToolTip(obs_module_text("ExportTemplateFileSuffixTooltip"));
+	formLayout->addRow(obs_module_text("ExportTemplateFileSuffix"), suffixEdit);
+
+	QComboBox *escapeCombo = new QComboBox(dialog);
+	escapeCombo->setToolTip(obs_module_text("ExportTemplateEscapeTooltip"));
+	escapeCombo->addItem(obs_module_text("ExportTemplateEscapeNone"), "none");
+	escapeCombo->addItem("XML", "xml");
+	escapeCombo->addItem("JSON", "json");
+	escapeCombo->setCurrentIndex(qMax(0, escapeCombo->findData(exportTemplate.escapeName)));
+	formLayout->addRow(obs_module_text("ExportTemplateEscape"), escapeCombo);
+
+	auto addTemplateEdit = [&](const char *labelKey, const QString &text) {
+		QPlainTextEdit *edit = new QPlainTextEdit(text, dialog);
+		edit->setFixedHeight(edit->fontMetrics().lineSpacing() * 4);
+		formLayout->addRow(obs_module_text(labelKey), edit);
+		return edit;
+	};
+	QPlainTextEdit *headerEdit = addTemplateEdit("ExportTemplateHeader", exportTemplate.headerSource);
+	QPlainTextEdit *markerEdit = addTemplateEdit("ExportTemplateMarker", exportTemplate.markerSource);
+	QPlainTextEdit *annotationEdit = addTemplateEdit("ExportTemplateAnnotation", exportTemplate.annotationSource);
+	QPlainTextEdit *footerEdit = addTemplateEdit("ExportTemplateFooter", exportTemplate.footerSource);
+	mainLayout->addLayout(formLayout);
+
+	QLabel *errorLabel = new QLabel("", dialog);
+	errorLabel->setProperty("themeID", Constants::THEME_ERROR);
+	errorLabel->setWordWrap(true);
+	mainLayout->addWidget(errorLabel);
+
+	QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, dialog);
+	connect(buttonBox, &QDialogButtonBox::accepted, this,
+		[this, dialog, suffixEdit, escapeCombo, headerEdit, markerEdit, annotationEdit, footerEdit, errorLabel]() {
+			ExportTemplate edited;
+			edited.fileSuffix = suffixEdit->text().trimmed();
+			edited.escapeName = escapeCombo->currentData().toString();
+			edited.headerSource = headerEdit->toPlainText();
+			edited.markerSource = markerEdit->toPlainText();
+			edited.annotationSource = annotationEdit->toPlainText();
+			edited.footerSource = footerEdit->toPlainText();
+
+			// Keep the dialog open until every template compiles
+			if (!edited.compile()) {
+				const QString errors = edited.header.errorString() + " " + edited.marker.errorString() + " " +
+						       edited.annotation.errorString() + " " + edited.footer.errorString();
+				errorLabel->setText(QString::fromUtf8(obs_module_text("ExportTemplateInvalid")) + " " +
+						    errors.simplified());
+				style()->polish(errorLabel);
+				return;
+			}
+			if (!ExportTemplate::isValidFileSuffix(edited.fileSuffix)) {
+				errorLabel->setText(QString::fromUtf8(obs_module_text("ExportTemplateInvalid")) + " " +
+						    obs_module_text("ExportTemplateInvalidFileSuffix"));
+				style()->polish(errorLabel);
+				return;
+			}
+
+			errorLabel->clear();
+			if (edited.fileSuffix.isEmpty()) {
+				edited.fileSuffix = Constants::TEMPLATE_FILE_SUFFIX;
+			}
+			exportTemplate = edited;
+			SaveSettings();
+			dialog->accept();
+		});
+	connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+	mainLayout->addWidget(buttonBox);
+
+	dialog->setLayout(mainLayout);
+	dialog->adjustSize();
+
+	return dialog;
+}
+
+//--------------------WEBHOOKS UI--------------------
+QDialog *ChapterMarkerDock::createWebhooksUI()
+{
+	QDialog *dialog = new QDialog(this);
+	dialog->setWindowTitle(obs_module_text("Webhooks"));
+
+	QVBoxLayout *mainLayout = new QVBoxLayout(dialog);
+
+	QLabel *explanationLabel = new QLabel(obs_module_text("WebhooksExplanation"), dialog);
+	explanationLabel->setWordWrap(true);
+	mainLayout->addWidget(explanationLabel);
+
+	QPlainTextEdit *urlsEdit = new QPlainTextEdit(webhookSender.endpoints().join("\n"), dialog);
+	urlsEdit->setPlaceholderText("https://example.com/chapters");
+	urlsEdit->setFixedHeight(urlsEdit->fontMetrics().lineSpacing() * 6);
+	mainLayout->addWidget(urlsEdit);
+
+	QLabel *errorLabel = new QLabel("", dialog);
+	errorLabel->setProperty("themeID", Constants::THEME_ERROR);
+	errorLabel->setWordWrap(true);
+	mainLayout->addWidget(errorLabel);
+
+	QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, dialog);
+	connect(buttonBox, &QDialogButtonBox::accepted, this, [this, dialog, urlsEdit, errorLabel]() {
+		QStringList urls;
+		for (const QString &line : urlsEdit->toPlainText().split('\n', Qt::SkipEmptyParts)) {
+			const QString url = line.trimmed();
+			if (url.isEmpty()) {
+				continue;
+			}
+
+			// Keep the dialog open until every line is an HTTP address
+			const QUrl parsed(url, QUrl::StrictMode);
+			if (!parsed.isValid() || (parsed.scheme() != "http" && parsed.scheme() != "https") || parsed.host().isEmpty()) {
+				errorLabel->setText(QString::fromUtf8(obs_module_text("WebhooksInvalidUrl")) + " " + url);
+				style()->polish(errorLabel);
+				return;
+			}
+			if (!urls.contains(url)) {
+				urls << url;
+			}
+		}
+
+		errorLabel->clear();
+		webhookSender.setEndpoints(urls);
+		SaveSettings();
+		dialog->accept();
+	});
+	connect(buttonBox, &QDialogButtonBox::rejected, dialog, &QDialog::reject);
+	mainLayout->addWidget(buttonBox);
+
+	dialog->setLayout(mainLayout);
+	dialog->adjustSize();
+
+	return dialog;
+}
+
+//--------------------RECORDING SEARCH--------------------
+void ChapterMarkerDock::openSessionCatalog()
+{
+	char *catalogPath = obs_module_config_path(Constants::SESSION_CATALOG_FILE_NAME);
+	if (!catalogPath) {
+		return;
+	}
+	const QString filePath = QString::fromUtf8(catalogPath);
+	bfree(catalogPath);
+
+	// Searches made while it loads wait for the index instead of seeing it half built
+	catalogPool.start([this, filePath]() {
+		if (sessionCatalog.open(filePath)) {
+			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Session catalog holds %d recordings", sessionCatalog.sessionCount());
+		} else {
+			blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not read session catalog: %s", QT_TO_UTF8(filePath));
+		}
+	});
+}
+
+void ChapterMarkerDock::addSessionToCatalog()
+{
+	char *lastRecording = obs_frontend_get_last_recording();
+	if (!lastRecording) {
+		return;
+	}
+
+	SessionCatalog::Session session;
+	session.recordingPath = QDir::fromNativeSeparators(QString::fromUtf8(lastRecording));
+	bfree(lastRecording);
+	session.timebase = recordingTimebase;
+	session.recordedAtMs = recordingStartAnchor.wallClockNs / 1000000;
+
+	// Read from the session state now, it is cleared as soon as this returns
+	for (const SessionMarker &marker : sessionMarkers) {
+		if (!marker.deleted) {
+			session.entries.append(
+				{marker.frameOffset, false, sessionStrings.text(marker.name), sessionStrings.text(marker.source)});
+		}
+	}
+	session.entries += sessionAnnotations;
+	std::stable_sort(session.entries.begin(), session.entries.end(),
+			 [](const SessionCatalog::Entry &a, const SessionCatalog::Entry &b) { return a.frameOffset < b.frameOffset; });
+
+	catalogPool.start([this, session]() {
+		if (!sessionCatalog.add(session)) {
+			blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not add recording to session catalog: %s",
+			     QT_TO_UTF8(session.recordingPath));
+		}
+	});
+}
+
+void ChapterMarkerDock::startCatalogBackfill(const QString &folderPath)
+{
+	recordingSearchIndexButton->setEnabled(false);
+	recordingSearchStatusLabel->setText(obs_module_text("RecordingSearchIndexing"));
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Adding recordings to session catalog from: %s", QT_TO_UTF8(folderPath));
+
+	// Walking the folder can be slow on network drives, so it runs on the pool as well
+	catalogPool.start([this, folderPath]() {
+		// One sidecar per recording, the binary index wins over the text file
+		QHash<QString, QString> sidecarByBase;
+		QDirIterator it(folderPath,
+				{QString("*") + Constants::CHAPTER_INDEX_FILE_SUFFIX, QString("*") + Constants::TEXT_FILE_SUFFIX},
+				QDir::Files, QDirIterator::Subdirectories);
+		while (it.hasNext()) {
+			const QString filePath = it.next();
+			const bool isIndex = filePath.endsWith(Constants::CHAPTER_INDEX_FILE_SUFFIX);
+			const QString basePath = filePath.chopped(static_cast<qsizetype>(
+				strlen(isIndex ? Constants::CHAPTER_INDEX_FILE_SUFFIX : Constants::TEXT_FILE_SUFFIX)));
+			if (isIndex || !sidecarByBase.contains(basePath)) {
+				sidecarByBase.insert(basePath, filePath);
+			}
+		}
+
+		if (sidecarByBase.isEmpty()) {
+			QMetaObject::invokeMethod(this, [this]() { onCatalogBackfillFinished(0); }, Qt::QueuedConnection);
+			return;
+		}
+
+		// Every recording is read on its own task, the last one to finish reports back
+		auto remaining = std::make_shared<QAtomicInteger<int>>(static_cast<int>(sidecarByBase.size()));
+		auto added = std::make_shared<QAtomicInteger<int>>(0);
+		for (const QString &sidecarPath : sidecarByBase) {
+			catalogPool.start([this, sidecarPath, remaining, added]() {
+				SessionCatalog::Session session;
+				const bool read = sidecarPath.endsWith(Constants::CHAPTER_INDEX_FILE_SUFFIX)
+							  ? SessionCatalog::readChapterIndex(sidecarPath, session)
+							  : SessionCatalog::readChapterText(sidecarPath, session);
+				if (read && sessionCatalog.add(session)) {
+					added->fetchAndAddRelaxed(1);
+				}
+				if (remaining->fetchAndSubRelaxed(1) == 1) {
+					const int addedCount = added->loadRelaxed();
+					QMetaObject::invokeMethod(
+						this, [this, addedCount]() { onCatalogBackfillFinished(addedCount); },
+						Qt::QueuedConnection);
+				}
+			});
+		}
+	});
+}
+
+void ChapterMarkerDock::onCatalogBackfillFinished(int addedCount)
+{
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Added %d recordings to session catalog", addedCount);
+	if (!recordingSearchDialog) {
+		return;
+	}
+
+	recordingSearchIndexButton->setEnabled(true);
+	updateRecordingSearchResults();
+	recordingSearchStatusLabel->setText(
+		QString("%1 %2").arg(obs_module_text("RecordingSearchIndexed")).arg(addedCount) + " - " +
+		QString("%1 %2").arg(obs_module_text("RecordingSearchSessionCount")).arg(sessionCatalog.sessionCount()));
+}
+
+QDialog *ChapterMarkerDock::createRecordingSearchUI()
+{
+	QDialog *dialog = new QDialog(this);
+	dialog->setWindowTitle(obs_module_text("GeneralSettingsSearchRecordings"));
+	dialog->resize(640, 420);
+
+	QVBoxLayout *mainLayout = new QVBoxLayout(dialog);
+
+	recordingSearchEdit = new QLineEdit(dialog);
+	recordingSearchEdit->setPlaceholderText(obs_module_text("RecordingSearchPlaceholder"));
+	recordingSearchEdit->setClearButtonEnabled(true);
+	mainLayout->addWidget(recordingSearchEdit);
+
+	recordingSearchResults = new QListWidget(dialog);
+	recordingSearchResults->setToolTip(obs_module_text("RecordingSearchResultsTooltip"));
+	mainLayout->addWidget(recordingSearchResults);
+
+	QHBoxLayout *footerLayout = new QHBoxLayout();
+	recordingSearchStatusLabel = new QLabel(dialog);
+	recordingSearchIndexButton = new QPushButton(obs_module_text("RecordingSearchIndexFolder"), dialog);
+	recordingSearchIndexButton->setToolTip(obs_module_text("RecordingSearchIndexFolderTooltip"));
+	footerLayout->addWidget(recordingSearchStatusLabel, 1);
+	footerLayout->addWidget(recordingSearchIndexButton);
+	mainLayout->addLayout(footerLayout);
+
+	// The index answers in well under a frame, so every keystroke searches
+	connect(recordingSearchEdit, &QLineEdit::textChanged, this, &ChapterMarkerDock::updateRecordingSearchResults);
+
+	connect(recordingSearchResults, &QListWidget::itemDoubleClicked, this, [](QListWidgetItem *item) {
+		const QString recordingPath = item->data(Qt::UserRole).toString();
+		QDesktopServices::openUrl(QUrl::fromLocalFile(QFileInfo(recordingPath).absolutePath()));
+	});
+
+	connect(recordingSearchIndexButton, &QPushButton::clicked, this, [this, dialog]() {
+		const QString folderPath =
+			QFileDialog::getExistingDirectory(dialog, obs_module_text("RecordingSearchIndexFolderTitle"));
+		if (!folderPath.isEmpty()) {
+			startCatalogBackfill(folderPath);
+		}
+	});
+
+	return dialog;
+}
+
+void ChapterMarkerDock::updateRecordingSearchResults()
+{
+	recordingSearchResults->clear();
+	const QString query = recordingSearchEdit->text();
+	if (query.trimmed().isEmpty()) {
+		recordingSearchStatusLabel->setText(
+			QString("%1 %2").arg(obs_module_text("RecordingSearchSessionCount")).arg(sessionCatalog.sessionCount()));
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	const QVector<SessionCatalog::Match> matches = sessionCatalog.search(query);
+	const double elapsedMs = static_cast<double>(timer.nsecsElapsed()) / 1000000.0;
+
+	char timestamp[Timecode::BUFFER_SIZE];
+	for (const SessionCatalog::Match &match : matches) {
+		const QString time = QString::fromLatin1(
+			timestamp, static_cast<qsizetype>(Timecode::formatHms(timestamp, match.entry.frameOffset, match.timebase)));
+		const QString date = QDateTime::fromMSecsSinceEpoch(match.recordedAtMs).toString("yyyy-MM-dd");
+		const QString text = match.entry.annotation ? AnnotationStore::makeTitle(match.entry.text, Constants::ANNOTATION_TITLE_LENGTH)
+							    : match.entry.text;
+
+		QListWidgetItem *item =
+			new QListWidgetItem(QString("%1  %2  %3  (%4)").arg(date, time, text, QFileInfo(match.recordingPath).fileName()));
+		item->setData(Qt::UserRole, match.recordingPath);
+		item->setToolTip(match.recordingPath);
+		recordingSearchResults->addItem(item);
+	}
+
+	recordingSearchStatusLabel->setText(matches.isEmpty() ? QString(obs_module_text("RecordingSearchNoResults"))
+							      : QString("%1 %2 (%3 ms)")
+									.arg(obs_module_text("RecordingSearchResults"))
+									.arg(matches.size())
+									.arg(elapsedMs, 0, 'f', 2));
+}
+
 //--------------------IGNORED SCENES UI--------------------
 QDialog *ChapterMarkerDock::createIgnoredScenesUI()
 {
@@ -1012,394 +1845,682 @@ void ChapterMarkerDock::createExportFiles()
 	QString baseName = fileInfo.completeBaseName();
 	QString directoryPath = fileInfo.absolutePath();
 
-	if (exportChaptersToTextEnabled) {
+	// The folder is chosen once per recording, later calls only create the files still missing
+	if (exportDirectoryPath.isEmpty()) {
+		// Live files go to the local staging folder and move next to the recording when it stops
+		activeStagingDirectory.clear();
+		if (stageExportFilesEnabled && !exportStagingDirectory.isEmpty()) {
+			const QString stagingPath = QDir(exportStagingDirectory).absolutePath();
+			if (QDir().mkpath(stagingPath)) {
+				activeStagingDirectory = stagingPath;
+				stagedRecordingDirectory = directoryPath;
+				stagedBaseName = baseName;
+				directoryPath = stagingPath;
+				blog(LOG_INFO, "[StreamUP Record Chapter Manager] Staging export files in: %s", QT_TO_UTF8(stagingPath));
+			} else {
+				blog(LOG_WARNING,
+				     "[StreamUP Record Chapter Manager] Could not create staging folder, writing next to the recording: %s",
+				     QT_TO_UTF8(stagingPath));
+			}
+		}
+		exportDirectoryPath = directoryPath;
+	}
+	directoryPath = exportDirectoryPath;
+
+	annotationStore.open(directoryPath + "/" + baseName + Constants::ANNOTATION_STORE_FILE_SUFFIX);
+
+	if (exportChaptersToTextEnabled && exportTextFilePath.isEmpty()) {
 		const QString chapterFilePath = directoryPath + "/" + baseName + Constants::TEXT_FILE_SUFFIX;
-		QFile file(chapterFilePath);
-		if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-			QTextStream out(&file);
-			out << "Chapter Markers for " << baseName << "\n";
-			file.close();
+		setExportTextFilePath(chapterFilePath);
+		if (textSidecar.create(ChapterExport::textHeader(baseName))) {
 			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Created chapter file: %s", QT_TO_UTF8(chapterFilePath));
-			setExportTextFilePath(chapterFilePath);
 		} else {
 			blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to create chapter file: %s",
 			     QT_TO_UTF8(chapterFilePath));
+			setExportTextFilePath(QString());
 		}
 	}
 
-	if (exportChaptersToFCPXMLEnabled) {
+	if (exportChaptersToFCPXMLEnabled && exportFCPXMLFilePath.isEmpty()) {
 		const QString fcpXmlFilePath = directoryPath + "/" + baseName + Constants::FCPXML_FILE_SUFFIX;
-		QFile fcpXmlFile(fcpXmlFilePath);
-		if (fcpXmlFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-			QTextStream out(&fcpXmlFile);
-			// Get frame rate
-			obs_video_info ovi;
-			int fps = 30;
-			if (obs_get_video_info(&ovi)) {
-				fps = static_cast<int>(round(static_cast<double>(ovi.fps_num) / ovi.fps_den));
-			}
-
-			out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-			out << "<!DOCTYPE xmeml>\n";
-			out << "<xmeml version=\"5\">\n";
-			out << "  <clip>\n";
-			out << "    <rate>\n";
-			out << "      <timebase>" << fps << "</timebase>\n";
-			out << "    </rate>\n";
-			out << "    <media>\n";
-			out << "      <video>\n";
-			out << "        <track>\n";
-			out << "          <clipitem>\n";
-			out << "            <file id=\"file1\">\n";
-			out << "              <pathurl>" << baseName << "</pathurl>\n";
-			out << "              <media>\n";
-			out << "                <video/>\n";
-			out << "              </media>\n";
-			out << "            </file>\n";
-			fcpXmlFile.close();
+		setExportFCPXMLFilePath(fcpXmlFilePath);
+		// Closed from the start so tools reading the file live always see a complete document
+		if (fcpXmlSidecar.create(ChapterExport::fcpXmlHeader(baseName, recordingTimebase)) &&
+		    fcpXmlSidecar.setTrailer(ChapterExport::FCPXML_FOOTER)) {
 			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Created FCP XML chapter file: %s", QT_TO_UTF8(fcpXmlFilePath));
-			setExportFCPXMLFilePath(fcpXmlFilePath);
 		} else {
 			blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to create FCP XML chapter file: %s",
 			     QT_TO_UTF8(fcpXmlFilePath));
+			setExportFCPXMLFilePath(QString());
 		}
 	}
 
-	if (exportChaptersToPremiereXMLEnabled) {
+	if (exportChaptersToPremiereXMLEnabled && exportPremiereXMLFilePath.isEmpty()) {
 		const QString premiereXmlFilePath = directoryPath + "/" + baseName + Constants::PREMIEREXML_FILE_SUFFIX;
-		QFile premiereXmlFile(premiereXmlFilePath);
-		if (premiereXmlFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-			QTextStream out(&premiereXmlFile);
-			// Get frame rate
-			obs_video_info ovi;
-			int fps = 30;
-			bool isNtsc = false;
-			if (obs_get_video_info(&ovi)) {
-				fps = static_cast<int>(round(static_cast<double>(ovi.fps_num) / ovi.fps_den));
-				// Check if it's NTSC (29.97 or 59.94)
-				double actualFps = static_cast<double>(ovi.fps_num) / ovi.fps_den;
-				isNtsc = (fabs(actualFps - 29.97) < 0.01) || (fabs(actualFps - 59.94) < 0.01);
-			}
-
-			out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-			out << "<!DOCTYPE xmeml>\n";
-			out << "<xmeml version=\"4\">\n";
-			out << "\t<sequence id=\"sequence-1\">\n";
-			out << "\t\t<name>" << baseName << "</name>\n";
-			out << "\t\t<rate>\n";
-			out << "\t\t\t<timebase>" << fps << "</timebase>\n";
-			out << "\t\t\t<ntsc>" << (isNtsc ? "TRUE" : "FALSE") << "</ntsc>\n";
-			out << "\t\t</rate>\n";
-			out << "\t\t<media>\n";
-			out << "\t\t\t<video>\n";
-			out << "\t\t\t\t<track>\n";
-			out << "\t\t\t\t\t<enabled>TRUE</enabled>\n";
-			out << "\t\t\t\t\t<locked>FALSE</locked>\n";
-			out << "\t\t\t\t</track>\n";
-			out << "\t\t\t</video>\n";
-			out << "\t\t</media>\n";
-			out << "\t\t<timecode>\n";
-			out << "\t\t\t<rate>\n";
-			out << "\t\t\t\t<timebase>" << fps << "</timebase>\n";
-			out << "\t\t\t\t<ntsc>" << (isNtsc ? "TRUE" : "FALSE") << "</ntsc>\n";
-			out << "\t\t\t</rate>\n";
-			out << "\t\t\t<string>00;00;00;00</string>\n";
-			out << "\t\t\t<frame>0</frame>\n";
-			out << "\t\t\t<displayformat>DF</displayformat>\n";
-			out << "\t\t</timecode>\n";
-			premiereXmlFile.close();
+		setExportPremiereXMLFilePath(premiereXmlFilePath);
+		if (premiereXmlSidecar.create(ChapterExport::premiereXmlHeader(baseName, recordingTimebase)) &&
+		    premiereXmlSidecar.setTrailer(ChapterExport::PREMIEREXML_FOOTER)) {
 			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Created Premiere XML chapter file: %s", QT_TO_UTF8(premiereXmlFilePath));
-			setExportPremiereXMLFilePath(premiereXmlFilePath);
 		} else {
 			blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to create Premiere XML chapter file: %s",
 			     QT_TO_UTF8(premiereXmlFilePath));
+			setExportPremiereXMLFilePath(QString());
 		}
 	}
 
-	if (exportChaptersToEDLEnabled) {
-		const QString edlFilePath = directoryPath + "/" + baseName + Constants::EDL_FILE_SUFFIX;
-		QFile edlFile(edlFilePath);
-		if (edlFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-			QTextStream out(&edlFile);
-			out << "TITLE: " << baseName << "\n";
-			out << "FCM: NON-DROP FRAME\n\n";
-			edlFile.close();
-			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Created EDL chapter file: %s", QT_TO_UTF8(edlFilePath));
-			setExportEDLFilePath(edlFilePath);
+	// Recreating the template file would restart its marker numbering
+	if (exportChaptersToTemplateEnabled && exportTemplateFilePath.isEmpty()) {
+		exportTemplateFilePath = directoryPath + "/" + baseName + exportTemplate.fileSuffix;
+		templateMarkerIndex = 1;
+		setTemplateFields(baseName, 0, QString());
+		templateSidecar.reset(exportTemplateFilePath);
+		if (templateSidecar.create(renderTemplate(exportTemplate.header))) {
+			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Created custom template chapter file: %s",
+			     QT_TO_UTF8(exportTemplateFilePath));
 		} else {
-			blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to create EDL chapter file: %s",
-			     QT_TO_UTF8(edlFilePath));
+			blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to create custom template chapter file: %s",
+			     QT_TO_UTF8(exportTemplateFilePath));
+			exportTemplateFilePath.clear();
 		}
 	}
-}
-
-void ChapterMarkerDock::setExportTextFilePath(const QString &filePath)
-{
-	exportTextFilePath = filePath;
-}
 
-void ChapterMarkerDock::writeChapterToTextFile(const QString &chapterName, const QString &timestamp, const QString &chapterSource)
-{
-	if (!exportChaptersToFileEnabled || !exportChaptersToTextEnabled) {
-		return;
+	// Parts already written would lose their numbering and the first file its events
+	if (exportChaptersToEDLEnabled && exportEDLFilePath.isEmpty()) {
+		edlFileBasePath = directoryPath + "/" + baseName;
+		edlPartNumber = 1;
+		edlEventNumber = 1;
+		finishedEdlSidecars.clear();
+		createEDLFile(edlFileBasePath + Constants::EDL_FILE_SUFFIX, baseName);
 	}
 
-	if (exportTextFilePath.isEmpty()) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Chapter file path is not set, creating a new file.");
-		createExportFiles();
-		return;
+	// Readers may already be following the file, a later call in the same recording keeps it
+	if (exportChaptersToJsonLinesEnabled && !jsonLinesSidecar.isOpen()) {
+		const QString jsonLinesFilePath = directoryPath + "/" + baseName + Constants::JSON_LINES_FILE_SUFFIX;
+		if (jsonLinesSidecar.open(jsonLinesFilePath, baseName, QUuid::createUuid().toString(QUuid::WithoutBraces), recordingTimebase,
+					  jsonLinesDurability, jsonLinesSyncEvery)) {
+			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Created JSON Lines chapter file: %s", QT_TO_UTF8(jsonLinesFilePath));
+			if (jsonLinesDurability == JsonLinesSidecar::Durability::Interval) {
+				jsonLinesSyncTimer.start(jsonLinesSyncEvery);
+			}
+		} else {
+			blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to create JSON Lines chapter file: %s",
+			     QT_TO_UTF8(jsonLinesFilePath));
+		}
 	}
 
-	QString fullChapterName = chapterName;
+	// Creating the index again would truncate the markers already in it
+	if (exportChaptersToIndexEnabled && !chapterIndex.isOpen()) {
+		const QString indexFilePath = directoryPath + "/" + baseName + Constants::CHAPTER_INDEX_FILE_SUFFIX;
+		if (chapterIndex.create(indexFilePath, recordingTimebase, recordingStartAnchor)) {
+			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Created chapter index file: %s", QT_TO_UTF8(indexFilePath));
+		} else {
+			blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to create chapter index file: %s",
+			     QT_TO_UTF8(indexFilePath));
+		}
+	}
+}
 
-	// Ensure the chapter source is only appended once
-	if (addChapterSourceEnabled && !chapterName.contains(chapterSource)) {
-		fullChapterName += " (" + chapterSource + ")";
+void ChapterMarkerDock::writeToChapterIndex(uint64_t frameOffset, int markerId, const MarkerSource::Source &chapterSource,
+					     uint8_t flags, const QString &name)
+{
+	if (!exportChaptersToFileEnabled || !exportChaptersToIndexEnabled || !chapterIndex.isOpen()) {
+		return;
 	}
 
-	QString content = QString("%1 - %2\n").arg(timestamp, fullChapterName);
-	if (!writeToFile(exportTextFilePath, content)) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open text file: %s", QT_TO_UTF8(exportTextFilePath));
+	const uint32_t indexMarkerId = markerId < 0 ? ChapterIndex::NO_MARKER_ID : static_cast<uint32_t>(markerId);
+	if (!chapterIndex.append(frameOffset, indexMarkerId, static_cast<uint8_t>(chapterSource.kind), flags, name,
+				 chapterSource.label())) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to write chapter index file: %s",
+		     QT_TO_UTF8(chapterIndex.path()));
 	}
 }
 
-void ChapterMarkerDock::setExportFCPXMLFilePath(const QString &filePath)
+bool ChapterMarkerDock::createEDLFile(const QString &edlFilePath, const QString &title)
 {
-	exportFCPXMLFilePath = filePath;
-}
+	// The current part stays in use if the next one cannot be created
+	SidecarFile edlFile;
+	edlFile.reset(edlFilePath);
+	if (!edlFile.create(ChapterExport::edlHeader(title))) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to create EDL chapter file: %s", QT_TO_UTF8(edlFilePath));
+		return false;
+	}
 
-void ChapterMarkerDock::setExportPremiereXMLFilePath(const QString &filePath)
-{
-	exportPremiereXMLFilePath = filePath;
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Created EDL chapter file: %s", QT_TO_UTF8(edlFilePath));
+	setExportEDLFilePath(edlFilePath);
+	return true;
 }
 
-void ChapterMarkerDock::setExportEDLFilePath(const QString &filePath)
+bool ChapterMarkerDock::rollOverEDLFile(uint64_t frameOffset)
 {
-	exportEDLFilePath = filePath;
-}
+	// CMX3600 event numbers are three digits, continue in a numbered part file
+	const QString baseName = QFileInfo(edlFileBasePath).fileName();
+	const QString manifestPath = edlFileBasePath + Constants::EDL_MANIFEST_FILE_SUFFIX;
+	const int nextPart = edlPartNumber + 1;
+	const QString partSuffix = QString("_%1").arg(nextPart, 3, 10, QChar('0'));
+	const QString partFilePath = edlFileBasePath + "_chapters" + partSuffix + ".edl";
 
-QString ChapterMarkerDock::convertTimestampToTimecode(const QString &timestamp, int frameNumber) const
-{
-	// Convert HH:MM:SS timestamp to HH:MM:SS:FF timecode format
-	// Parse the timestamp
-	QTime time = QTime::fromString(timestamp, "HH:mm:ss");
-	if (!time.isValid()) {
-		return "01:00:00:00"; // Default fallback
+	const SidecarFile finishedPart = edlSidecar;
+	if (!createEDLFile(partFilePath, QString("%1 (Part %2)").arg(baseName).arg(nextPart))) {
+		return false;
 	}
+	finishedEdlSidecars.append(finishedPart);
 
-	// Get frame rate from OBS
-	obs_video_info ovi;
-	int fps = 30; // Default fallback
-	if (obs_get_video_info(&ovi)) {
-		fps = static_cast<int>(round(static_cast<double>(ovi.fps_num) / ovi.fps_den));
+	// The manifest lists every part in order with the recording time it starts at
+	QString manifest;
+	if (edlPartNumber == 1) {
+		manifest += QString("EDL parts for %1\n").arg(baseName);
+		manifest += QString("%1 - %2 %3\n")
+				    .arg(1, 3, 10, QChar('0'))
+				    .arg(QString(Constants::DEFAULT_TIMESTAMP), baseName + Constants::EDL_FILE_SUFFIX);
+	}
+	manifest += QString("%1 - %2 %3\n")
+			    .arg(nextPart, 3, 10, QChar('0'))
+			    .arg(formatRecordingTime(frameOffset), QFileInfo(partFilePath).fileName());
+	if (!writeToFile(manifestPath, manifest)) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open EDL manifest file: %s", QT_TO_UTF8(manifestPath));
 	}
 
-	// Format: HH:MM:SS:FF where FF is frame number (00-29 for 30fps)
-	// For markers, we use frame 00 for start and 01 for end (1 frame duration)
-	return QString("%1:%2:%3:%4")
-		.arg(time.hour() + 1, 2, 10, QChar('0'))  // Add 1 hour offset like in the example
-		.arg(time.minute(), 2, 10, QChar('0'))
-		.arg(time.second(), 2, 10, QChar('0'))
-		.arg(frameNumber, 2, 10, QChar('0'));
+	edlPartNumber = nextPart;
+	edlEventNumber = 1;
+	return true;
 }
 
-void ChapterMarkerDock::writeChapterToFCPXMLFile(const QString &chapterName, const QString &timestamp, const QString &chapterSource)
+extern bool (*obs_frontend_recording_add_chapter_wrapper)(const char *name);
+
+void ChapterMarkerDock::probeInContainerChapterSupport()
 {
-	if (!exportChaptersToFileEnabled || !exportChaptersToFCPXMLEnabled) {
+	inContainerChaptersSupported = false;
+	deferredChapters.clear();
+	deferredChaptersFilePath.clear();
+
+	if (!insertChapterMarkersInVideoEnabled) {
 		return;
 	}
 
-	if (exportFCPXMLFilePath.isEmpty()) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] FCP XML file path is not set, creating a new file.");
-		createExportFiles();
+	obs_output_t *output = obs_frontend_get_recording_output();
+	if (!output) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Could not get the recording output.");
 		return;
 	}
 
-	// Convert timestamp HH:MM:SS to frame number
-	QTime time = QTime::fromString(timestamp, "HH:mm:ss");
-	int totalSeconds = time.hour() * 3600 + time.minute() * 60 + time.second();
+	// Only the hybrid MP4/MOV outputs handle the frontend add_chapter call
+	const char *outputId = obs_output_get_id(output);
+	const bool hybridOutput = outputId && (strcmp(outputId, Constants::HYBRID_MP4_OUTPUT_ID) == 0 ||
+					       strcmp(outputId, Constants::HYBRID_MOV_OUTPUT_ID) == 0);
+	inContainerChaptersSupported = hybridOutput && obs_frontend_recording_add_chapter_wrapper;
 
-	obs_video_info ovi;
-	int fps = 30;
-	if (obs_get_video_info(&ovi)) {
-		fps = static_cast<int>(round(static_cast<double>(ovi.fps_num) / ovi.fps_den));
+	obs_data_t *settings = obs_output_get_settings(output);
+	if (settings) {
+		const char *recording_path = obs_data_get_string(settings, "path");
+		if (recording_path && *recording_path) {
+			QFileInfo fileInfo(QString::fromUtf8(recording_path));
+			deferredChaptersFilePath =
+				fileInfo.absolutePath() + "/" + fileInfo.completeBaseName() + Constants::FFMETADATA_FILE_SUFFIX;
+		}
+		obs_data_release(settings);
 	}
+	obs_output_release(output);
 
-	int frameNumber = totalSeconds * fps;
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Recording output '%s' %s in-video chapters.",
+	     outputId ? outputId : "", inContainerChaptersSupported ? "supports" : "does not support");
 
-	QFile file(exportFCPXMLFilePath);
-	if (!file.open(QIODevice::Append | QIODevice::Text)) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open FCP XML file: %s", QT_TO_UTF8(exportFCPXMLFilePath));
-		return;
+	if (!inContainerChaptersSupported) {
+		disableInContainerChapters();
 	}
+}
 
-	QString fullChapterName = chapterName;
-	if (addChapterSourceEnabled && !chapterName.contains(chapterSource)) {
-		fullChapterName += " (" + chapterSource + ")";
-	}
+void ChapterMarkerDock::disableInContainerChapters()
+{
+	inContainerChaptersSupported = false;
 
-	QTextStream out(&file);
-	out << "            <marker>\n";
-	out << "              <comment>" << fullChapterName << "</comment>\n";
-	out << "              <name>" << chapterName << "</name>\n";
-	out << "              <in>" << frameNumber << "</in>\n";
-	out << "              <out>-1</out>\n";
-	out << "            </marker>\n";
-	file.close();
+	const char *noticeKey = "InContainerChaptersUnsupported";
+	if (deferInContainerChaptersEnabled && !deferredChaptersFilePath.isEmpty()) {
+		blog(LOG_INFO, "[StreamUP Record Chapter Manager] In-video chapters will be written to: %s",
+		     QT_TO_UTF8(deferredChaptersFilePath));
+		noticeKey = "InContainerChaptersDeferred";
+	} else {
+		blog(LOG_WARNING,
+		     "[StreamUP Record Chapter Manager] In-video chapters are not supported by this recording format and are disabled for this recording.");
+	}
 
-	fcpMarkerID++;
+	// Queued so the notice is not replaced by the feedback of the marker being added right now
+	QTimer::singleShot(0, this, [this, noticeKey]() { showFeedbackMessage(obs_module_text(noticeKey), true); });
 }
 
-void ChapterMarkerDock::writeChapterToPremiereXMLFile(const QString &chapterName, const QString &timestamp, const QString &chapterSource)
+FinalizeTask ChapterMarkerDock::finalizeDeferredChaptersFile()
 {
-	if (!exportChaptersToFileEnabled || !exportChaptersToPremiereXMLEnabled) {
-		return;
+	if (deferredChapters.isEmpty() || deferredChaptersFilePath.isEmpty()) {
+		deferredChapters.clear();
+		return FinalizeTask();
 	}
 
-	if (exportPremiereXMLFilePath.isEmpty()) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Premiere XML file path is not set, creating a new file.");
-		createExportFiles();
-		return;
-	}
+	// FFmetadata chapters need an end time, each one runs until the next starts
+	const qint64 recordingEndMs = getCurrentRecordingMilliseconds();
 
-	// Convert timestamp HH:MM:SS to frame number
-	QTime time = QTime::fromString(timestamp, "HH:mm:ss");
-	int totalSeconds = time.hour() * 3600 + time.minute() * 60 + time.second();
+	QString content;
+	QTextStream out(&content);
+	out << ";FFMETADATA1\n";
+	for (int i = 0; i < deferredChapters.size(); ++i) {
+		const DeferredChapter &chapter = deferredChapters.at(i);
+		const qint64 endMs = i + 1 < deferredChapters.size() ? deferredChapters.at(i + 1).timeMs : recordingEndMs;
 
-	obs_video_info ovi;
-	int fps = 30;
-	if (obs_get_video_info(&ovi)) {
-		fps = static_cast<int>(round(static_cast<double>(ovi.fps_num) / ovi.fps_den));
+		QString title = sessionStrings.text(chapter.name);
+		title.replace("\\", "\\\\").replace("=", "\\=").replace(";", "\\;").replace("#", "\\#").replace("\n", "\\\n");
+
+		out << "\n[CHAPTER]\n";
+		out << "TIMEBASE=1/1000\n";
+		out << "START=" << chapter.timeMs << "\n";
+		out << "END=" << qMax(endMs, chapter.timeMs) << "\n";
+		out << "title=" << title << "\n";
 	}
+	out.flush();
 
-	int frameNumber = totalSeconds * fps;
+	const int chapterTotal = static_cast<int>(deferredChapters.size());
+	deferredChapters.clear();
 
-	QFile file(exportPremiereXMLFilePath);
-	if (!file.open(QIODevice::Append | QIODevice::Text)) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open Premiere XML file: %s", QT_TO_UTF8(exportPremiereXMLFilePath));
+	const QString filePath = deferredChaptersFilePath;
+	return {"ffmetadata", filePath, [filePath, utf8 = content.toUtf8(), chapterTotal]() {
+			QFile file(filePath);
+			if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || file.write(utf8) != utf8.size()) {
+				return false;
+			}
+			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Wrote %d deferred chapters to: %s", chapterTotal,
+			     QT_TO_UTF8(filePath));
+			return true;
+		}};
+}
+
+void ChapterMarkerDock::resetExportFiles()
+{
+	setExportTextFilePath(QString());
+	setExportFCPXMLFilePath(QString());
+	setExportPremiereXMLFilePath(QString());
+	setExportEDLFilePath(QString());
+	exportTemplateFilePath.clear();
+	activeStagingDirectory.clear();
+	exportDirectoryPath.clear();
+}
+
+void ChapterMarkerDock::setExportTextFilePath(const QString &filePath)
+{
+	exportTextFilePath = filePath;
+	textSidecar.reset(filePath);
+}
+
+void ChapterMarkerDock::writeChapterToTextFile(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+					       int markerId)
+{
+	if (!exportChaptersToFileEnabled || !exportChaptersToTextEnabled) {
 		return;
 	}
 
-	QString fullChapterName = chapterName;
-	if (addChapterSourceEnabled && !chapterName.contains(chapterSource)) {
-		fullChapterName += " (" + chapterSource + ")";
+	if (exportTextFilePath.isEmpty()) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Chapter file path is not set, creating a new file.");
+		createExportFiles();
+		return;
 	}
 
-	QTextStream out(&file);
-	out << "\t\t<marker>\n";
-	out << "\t\t\t<comment></comment>\n";
-	out << "\t\t\t<name>" << fullChapterName << "</name>\n";
-	out << "\t\t\t<in>" << frameNumber << "</in>\n";
-	out << "\t\t\t<out>-1</out>\n";
-	out << "\t\t</marker>\n";
-	file.close();
+	textSidecar.append(formatTextMarker(chapterName, frameOffset, chapterSource), markerId);
 }
 
-void ChapterMarkerDock::closeFCPXMLFile()
+QByteArray ChapterMarkerDock::formatTextMarker(const QString &chapterName, uint64_t frameOffset,
+					       const MarkerSource::Source &chapterSource) const
 {
-	if (!exportChaptersToFCPXMLEnabled || exportFCPXMLFilePath.isEmpty()) {
+	return ChapterExport::textMarker(ChapterExport::fullName(chapterName, chapterSource.label(), addChapterSourceEnabled),
+					 frameOffset, recordingTimebase);
+}
+
+void ChapterMarkerDock::setExportFCPXMLFilePath(const QString &filePath)
+{
+	exportFCPXMLFilePath = filePath;
+	fcpXmlSidecar.reset(filePath);
+}
+
+void ChapterMarkerDock::setExportPremiereXMLFilePath(const QString &filePath)
+{
+	exportPremiereXMLFilePath = filePath;
+	premiereXmlSidecar.reset(filePath);
+}
+
+void ChapterMarkerDock::setExportEDLFilePath(const QString &filePath)
+{
+	exportEDLFilePath = filePath;
+	edlSidecar.reset(filePath);
+}
+
+void ChapterMarkerDock::writeChapterToFCPXMLFile(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+						 int markerId)
+{
+	if (!exportChaptersToFileEnabled || !exportChaptersToFCPXMLEnabled) {
 		return;
 	}
 
-	QFile file(exportFCPXMLFilePath);
-	if (!file.open(QIODevice::Append | QIODevice::Text)) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to close FCP XML file: %s", QT_TO_UTF8(exportFCPXMLFilePath));
+	if (exportFCPXMLFilePath.isEmpty()) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] FCP XML file path is not set, creating a new file.");
+		createExportFiles();
 		return;
 	}
 
-	QTextStream out(&file);
-	out << "          </clipitem>\n";
-	out << "        </track>\n";
-	out << "      </video>\n";
-	out << "    </media>\n";
-	out << "  </clip>\n";
-	out << "</xmeml>\n";
-	file.close();
+	if (fcpXmlSidecar.append(formatFCPXMLMarker(chapterName, frameOffset, chapterSource), markerId)) {
+		fcpMarkerID++;
+	}
+}
 
-	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Closed FCP XML file: %s", QT_TO_UTF8(exportFCPXMLFilePath));
+QByteArray ChapterMarkerDock::formatFCPXMLMarker(const QString &chapterName, uint64_t frameOffset,
+						 const MarkerSource::Source &chapterSource) const
+{
+	return ChapterExport::fcpXmlMarker(chapterName, ChapterExport::fullName(chapterName, chapterSource.label(), addChapterSourceEnabled),
+					   frameOffset);
 }
 
-void ChapterMarkerDock::closePremiereXMLFile()
+void ChapterMarkerDock::writeChapterToPremiereXMLFile(const QString &chapterName, uint64_t frameOffset,
+						      const MarkerSource::Source &chapterSource, int markerId)
 {
-	if (!exportChaptersToPremiereXMLEnabled || exportPremiereXMLFilePath.isEmpty()) {
+	if (!exportChaptersToFileEnabled || !exportChaptersToPremiereXMLEnabled) {
 		return;
 	}
 
-	QFile file(exportPremiereXMLFilePath);
-	if (!file.open(QIODevice::Append | QIODevice::Text)) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to close Premiere XML file: %s", QT_TO_UTF8(exportPremiereXMLFilePath));
+	if (exportPremiereXMLFilePath.isEmpty()) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Premiere XML file path is not set, creating a new file.");
+		createExportFiles();
 		return;
 	}
 
-	QTextStream out(&file);
-	out << "\t</sequence>\n";
-	out << "</xmeml>\n";
-	file.close();
+	premiereXmlSidecar.append(formatPremiereXMLMarker(chapterName, frameOffset, chapterSource), markerId);
+}
+
+QByteArray ChapterMarkerDock::formatPremiereXMLMarker(const QString &chapterName, uint64_t frameOffset,
+						      const MarkerSource::Source &chapterSource) const
+{
+	return ChapterExport::premiereXmlMarker(ChapterExport::fullName(chapterName, chapterSource.label(), addChapterSourceEnabled),
+						frameOffset);
+}
+
+void ChapterMarkerDock::closeFCPXMLFile()
+{
+	if (!exportChaptersToFCPXMLEnabled || exportFCPXMLFilePath.isEmpty()) {
+		return;
+	}
+
+	// The footer is already on disk, it only stops being moved
+	fcpXmlSidecar.clearTrailer();
+
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Closed FCP XML file: %s", QT_TO_UTF8(exportFCPXMLFilePath));
+}
+
+void ChapterMarkerDock::closePremiereXMLFile()
+{
+	if (!exportChaptersToPremiereXMLEnabled || exportPremiereXMLFilePath.isEmpty()) {
+		return;
+	}
+
+	premiereXmlSidecar.clearTrailer();
 
 	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Closed Premiere XML file: %s", QT_TO_UTF8(exportPremiereXMLFilePath));
 }
 
-void ChapterMarkerDock::writeChapterToEDLFile(const QString &chapterName, const QString &timestamp, const QString &chapterSource)
+void ChapterMarkerDock::setTemplateFields(const QString &name, uint64_t frameOffset, const QString &source)
 {
-	if (!exportChaptersToFileEnabled || !exportChaptersToEDLEnabled) {
+	ChapterExport::setTemplateFields(templateFieldValues, exportTemplate, name, frameOffset, source, templateMarkerIndex,
+					 recordingTimebase);
+}
+
+QByteArray ChapterMarkerDock::renderTemplate(const TextTemplate &textTemplate)
+{
+	return ChapterExport::renderTemplate(textTemplate, templateFieldValues, templateRenderBuffer);
+}
+
+void ChapterMarkerDock::writeChapterToTemplateFile(const QString &chapterName, uint64_t frameOffset,
+						   const MarkerSource::Source &chapterSource, bool isAnnotation,
+						   const QString &annotationId, int markerId)
+{
+	if (!exportChaptersToFileEnabled || !exportChaptersToTemplateEnabled) {
 		return;
 	}
 
-	if (exportEDLFilePath.isEmpty()) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] EDL file path is not set, creating a new file.");
+	if (exportTemplateFilePath.isEmpty()) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Custom template file path is not set, creating a new file.");
 		createExportFiles();
 		return;
 	}
 
-	QFile file(exportEDLFilePath);
-	if (!file.open(QIODevice::Append | QIODevice::Text)) {
-		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open EDL file: %s", QT_TO_UTF8(exportEDLFilePath));
+	setTemplateFields(chapterName, frameOffset, chapterSource.label());
+	templateFieldValues[ExportTemplate::FieldRef] = annotationId;
+	templateSidecar.append(renderTemplate(isAnnotation ? exportTemplate.annotation : exportTemplate.marker), markerId,
+			       templateMarkerIndex);
+	templateMarkerIndex++;
+}
+
+FinalizeTask ChapterMarkerDock::closeTemplateFile(uint64_t endFrame)
+{
+	if (!exportChaptersToTemplateEnabled || exportTemplateFilePath.isEmpty()) {
+		return FinalizeTask();
+	}
+
+	setTemplateFields(QFileInfo(exportTemplateFilePath).completeBaseName(), endFrame, QString());
+	const QByteArray footer = renderTemplate(exportTemplate.footer);
+	const QString filePath = exportTemplateFilePath;
+	exportTemplateFilePath.clear();
+
+	return {"template", filePath, [sidecar = templateSidecar, footer, filePath]() mutable {
+			if (!sidecar.append(footer)) {
+				return false;
+			}
+			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Closed custom template file: %s", QT_TO_UTF8(filePath));
+			return true;
+		}};
+}
+
+void ChapterMarkerDock::appendFinalizeTask(QVector<FinalizeTask> &tasks, FinalizeTask task)
+{
+	if (task.write) {
+		tasks.append(std::move(task));
+	}
+}
+
+void ChapterMarkerDock::appendStagedFileMoves(QVector<FinalizeTask> &tasks)
+{
+	// Only the files this recording created move, never whatever else sits in the staging folder
+	QStringList stagedPaths;
+	const auto addStagedPath = [this, &stagedPaths](const QString &path) {
+		const QFileInfo stagedFile(path);
+		if (path.isEmpty() || stagedPaths.contains(path) || stagedFile.absolutePath() != activeStagingDirectory ||
+		    !stagedFile.fileName().startsWith(stagedBaseName) || !stagedFile.exists()) {
+			return;
+		}
+		stagedPaths.append(path);
+	};
+	addStagedPath(textSidecar.path());
+	addStagedPath(fcpXmlSidecar.path());
+	addStagedPath(premiereXmlSidecar.path());
+	addStagedPath(templateSidecar.path());
+	for (const SidecarFile &finishedPart : finishedEdlSidecars) {
+		addStagedPath(finishedPart.path());
+	}
+	addStagedPath(edlSidecar.path());
+	if (!edlFileBasePath.isEmpty()) {
+		addStagedPath(edlFileBasePath + Constants::EDL_MANIFEST_FILE_SUFFIX);
+	}
+	addStagedPath(jsonLinesSidecar.path());
+	addStagedPath(chapterIndex.path());
+	const QString annotationStorePath = annotationStore.filePath();
+	addStagedPath(annotationStorePath);
+
+	for (const QString &stagedPath : stagedPaths) {
+		const QString finalPath = stagedRecordingDirectory + "/" + QFileInfo(stagedPath).fileName();
+		std::function<bool()> move = [stagedPath, finalPath]() {
+			return FileRelocate::move(stagedPath, finalPath);
+		};
+		if (stagedPath == annotationStorePath) {
+			AnnotationStore *store = &annotationStore;
+			move = [stagedPath, finalPath, store]() {
+				if (!FileRelocate::move(stagedPath, finalPath)) {
+					return false;
+				}
+				store->relocate(stagedPath, finalPath);
+				return true;
+			};
+		}
+
+		// Files that still get a final write move once that write is done, in the same task
+		auto existing = std::find_if(tasks.begin(), tasks.end(), [&stagedPath](const FinalizeTask &task) {
+			return task.filePath == stagedPath;
+		});
+		if (existing != tasks.end()) {
+			existing->write = [write = existing->write, move]() {
+				return write() && move();
+			};
+			existing->filePath = finalPath;
+		} else {
+			tasks.append({stagedFileFormat(stagedPath), finalPath, move});
+		}
+	}
+}
+
+const char *ChapterMarkerDock::stagedFileFormat(const QString &stagedPath) const
+{
+	if (stagedPath == exportFCPXMLFilePath) {
+		return "fcpxml";
+	}
+	if (stagedPath == exportPremiereXMLFilePath) {
+		return "premierexml";
+	}
+	if (stagedPath == chapterIndex.path()) {
+		return "index";
+	}
+	if (stagedPath == annotationStore.filePath()) {
+		return "annotations";
+	}
+	if (stagedPath.startsWith(edlFileBasePath)) {
+		return "edl";
+	}
+	return "sidecar";
+}
+
+void ChapterMarkerDock::startFinalizeTasks(const QVector<FinalizeTask> &tasks)
+{
+	struct Batch {
+		QMutex mutex;
+		QVector<FinalizeResult> results;
+		int remaining;
+		QElapsedTimer timer;
+	};
+
+	if (tasks.isEmpty()) {
+		onExportFilesFinalized({}, 0);
 		return;
 	}
 
-	// Convert timestamp to timecode format (HH:MM:SS:FF)
-	QString timecodeStart = convertTimestampToTimecode(timestamp, 0);
-	QString timecodeEnd = convertTimestampToTimecode(timestamp, 1);
+	auto batch = std::make_shared<Batch>();
+	batch->remaining = static_cast<int>(tasks.size());
+	batch->timer.start();
 
-	// EDL format:
-	// Event#  Reel   Track  Type  Source In  Source Out  Record In  Record Out
-	// Comment line with marker info
-	QTextStream out(&file);
+	// Each format is independent, the last one to finish reports the whole batch on the UI thread
+	QPointer<ChapterMarkerDock> dock(this);
+	for (const FinalizeTask &task : tasks) {
+		finalizePool.start(QRunnable::create([dock, batch, task]() {
+			const bool success = task.write();
+			if (!success) {
+				blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to finalize %s file: %s", task.format,
+				     QT_TO_UTF8(task.filePath));
+			}
 
-	// Write event line
-	out << QString("%1  001      V     C        %2 %3 %4 %5  \n")
-		.arg(edlEventNumber, 3, 10, QChar('0'))
-		.arg(timecodeStart)
-		.arg(timecodeEnd)
-		.arg(timecodeStart)
-		.arg(timecodeEnd);
+			QMutexLocker locker(&batch->mutex);
+			batch->results.append({task.format, task.filePath, success});
+			if (--batch->remaining > 0) {
+				return;
+			}
+			const QVector<FinalizeResult> results = batch->results;
+			const qint64 elapsedMs = batch->timer.elapsed();
+			locker.unlock();
 
-	// Write comment line with marker metadata
-	QString fullChapterName = chapterName;
-	if (addChapterSourceEnabled && !chapterName.contains(chapterSource)) {
-		fullChapterName += " (" + chapterSource + ")";
+			QMetaObject::invokeMethod(
+				dock.data(), [dock, results, elapsedMs]() {
+					if (dock) {
+						dock->onExportFilesFinalized(results, elapsedMs);
+					}
+				},
+				Qt::QueuedConnection);
+		}));
 	}
+}
 
-	// Use different colors based on source for visual distinction in DaVinci Resolve
-	QString markerColor = "ResolveColorBlue";
-	if (chapterSource.contains("Manual")) {
-		markerColor = "ResolveColorGreen";
-	} else if (chapterSource.contains("Scene")) {
-		markerColor = "ResolveColorYellow";
-	} else if (chapterSource.contains("Hotkey")) {
-		markerColor = "ResolveColorPurple";
+void ChapterMarkerDock::onExportFilesFinalized(const QVector<FinalizeResult> &results, qint64 elapsedMs)
+{
+	bool allSucceeded = true;
+	obs_data_array_t *filesArray = obs_data_array_create();
+	for (const FinalizeResult &result : results) {
+		allSucceeded = allSucceeded && result.success;
+
+		obs_data_t *fileData = obs_data_create();
+		obs_data_set_string(fileData, "format", result.format);
+		obs_data_set_string(fileData, "path", QT_TO_UTF8(result.filePath));
+		obs_data_set_bool(fileData, "success", result.success);
+		obs_data_array_push_back(filesArray, fileData);
+		obs_data_release(fileData);
 	}
 
-	out << fullChapterName << " |C:" << markerColor << " |M:" << chapterName << " |D:1\n\n";
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Finalized %d export files in %lld ms", static_cast<int>(results.size()),
+	     static_cast<long long>(elapsedMs));
 
-	file.close();
+	if (!results.isEmpty()) {
+		showFeedbackMessage(obs_module_text(allSucceeded ? "ExportFilesFinalized" : "ExportFilesFinalizeFailed"), !allSucceeded);
+	}
 
-	// Increment event number for next marker
-	edlEventNumber++;
+	obs_data_t *event_data = obs_data_create();
+	obs_data_set_bool(event_data, "success", allSucceeded);
+	obs_data_set_int(event_data, "durationMs", elapsedMs);
+	obs_data_set_array(event_data, "files", filesArray);
+	EmitChapterEvent("ChapterFilesFinalized", event_data);
+	obs_data_release(event_data);
+	obs_data_array_release(filesArray);
 }
 
-void ChapterMarkerDock::writeAnnotationToFiles(const QString &annotationText, const QString &timestamp,
-					       const QString &annotationSource)
+void ChapterMarkerDock::writeChapterToEDLFile(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+					      int markerId)
+{
+	if (!exportChaptersToFileEnabled || !exportChaptersToEDLEnabled) {
+		return;
+	}
+
+	if (exportEDLFilePath.isEmpty()) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] EDL file path is not set, creating a new file.");
+		createExportFiles();
+		return;
+	}
+
+	if (edlEventNumber > Constants::EDL_MAX_EVENTS && !rollOverEDLFile(frameOffset)) {
+		return;
+	}
+
+	if (edlSidecar.append(formatEDLMarker(chapterName, frameOffset, chapterSource, edlEventNumber), markerId, edlEventNumber)) {
+		// Increment event number for next marker
+		edlEventNumber++;
+	}
+}
+
+SidecarFile *ChapterMarkerDock::edlSidecarFor(int markerId)
+{
+	if (edlSidecar.hasMarker(markerId)) {
+		return &edlSidecar;
+	}
+	for (SidecarFile &part : finishedEdlSidecars) {
+		if (part.hasMarker(markerId)) {
+			return &part;
+		}
+	}
+	return nullptr;
+}
+
+QByteArray ChapterMarkerDock::formatEDLMarker(const QString &chapterName, uint64_t frameOffset,
+					      const MarkerSource::Source &chapterSource, int eventNumberValue) const
+{
+	return ChapterExport::edlMarker(chapterName, ChapterExport::fullName(chapterName, chapterSource.label(), addChapterSourceEnabled),
+					frameOffset, recordingTimebase, eventNumberValue, chapterSource.info().edlColor);
+}
+
+void ChapterMarkerDock::writeAnnotationToFiles(const QString &annotationText, uint64_t frameOffset,
+					       const MarkerSource::Source &annotationSource)
 {
 	if (!obs_frontend_recording_active()) {
 		setAnnotationFeedbackLabel(obs_module_text("AnnotationErrorOutputNotActive"), "error");
@@ -1416,45 +2537,78 @@ void ChapterMarkerDock::writeAnnotationToFiles(const QString &annotationText, co
 		return;
 	}
 
-	// Check and create export files if paths are empty
-	if (exportTextFilePath.isEmpty() ||
+	// Create only the files an enabled format is still missing
+	if ((exportChaptersToTextEnabled && exportTextFilePath.isEmpty()) ||
 	    (exportChaptersToFCPXMLEnabled && exportFCPXMLFilePath.isEmpty()) ||
 	    (exportChaptersToPremiereXMLEnabled && exportPremiereXMLFilePath.isEmpty())) {
 		createExportFiles();
 	}
 
+	lastWrittenFrameOffset = std::max(lastWrittenFrameOffset, frameOffset);
+
+	// The body goes to the annotation store once, the formats only get a title and its id
+	const QString annotationId = annotationStore.add(annotationText);
+	const QString annotationTitle =
+		annotationId.isEmpty() ? annotationText
+				       : AnnotationStore::makeTitle(annotationText, Constants::ANNOTATION_TITLE_LENGTH);
+	QString annotationReference = annotationTitle;
+	if (!annotationId.isEmpty()) {
+		annotationReference += " [#" + annotationId + "]";
+	}
+
 	// Prepare the full annotation text including the source
 	QString annotationName = QString::fromUtf8(obs_module_text("Annotation"));
-	QString fullAnnotationText = "(" + annotationName + ") " + annotationText + " (" + annotationSource + ")";
+	QString fullAnnotationText = "(" + annotationName + ") " + annotationReference + " (" + annotationSource.label() + ")";
 
 	// Writing to text file if enabled
 	if (exportChaptersToTextEnabled) {
-		if (!writeToFile(exportTextFilePath, QString("%1 - %2\n").arg(timestamp, fullAnnotationText))) {
-			blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open text file: %s",
-			     QT_TO_UTF8(exportTextFilePath));
+		char timestamp[Timecode::BUFFER_SIZE];
+		QByteArray line(timestamp, static_cast<qsizetype>(Timecode::formatHms(timestamp, frameOffset, recordingTimebase)));
+		line += " - ";
+		appendEscaped(line, fullAnnotationText, TextEscape::Mode::TextLine);
+		line += '\n';
+		if (!textSidecar.append(line)) {
 			return;
 		}
 	}
 
 	// Write annotations as markers to FCP XML
 	if (exportChaptersToFCPXMLEnabled) {
-		writeChapterToFCPXMLFile(fullAnnotationText, timestamp, annotationSource);
+		writeChapterToFCPXMLFile(fullAnnotationText, frameOffset, annotationSource);
 	}
 
 	// Write annotations as markers to Premiere XML
 	if (exportChaptersToPremiereXMLEnabled) {
-		writeChapterToPremiereXMLFile(fullAnnotationText, timestamp, annotationSource);
+		writeChapterToPremiereXMLFile(fullAnnotationText, frameOffset, annotationSource);
+	}
+
+	// Write annotations through the custom annotation template
+	if (exportChaptersToTemplateEnabled) {
+		writeChapterToTemplateFile(annotationTitle, frameOffset, annotationSource, true, annotationId);
+	}
+
+	if (exportChaptersToIndexEnabled) {
+		writeToChapterIndex(frameOffset, -1, annotationSource, ChapterIndex::RecordAnnotation, annotationTitle);
 	}
 
+	// Lines carry escaped newlines, the full text fits
+	if (jsonLinesSidecar.isOpen()) {
+		jsonLinesSidecar.writeMarker(true, -1, frameOffset, annotationText, annotationSource.webSocketName());
+	}
+
+	// The catalog indexes the full text, not the title the exports carry
+	sessionAnnotations.append({frameOffset, true, annotationText, annotationSource.label()});
+
 	setAnnotationFeedbackLabel(obs_module_text("AnnotationSaved"), "good");
 	annotationDock->annotationEdit->clear();
 
 	// Emit WebSocket event for the new annotation
 	obs_data_t *event_data = obs_data_create();
 	obs_data_set_string(event_data, "annotationText", QT_TO_UTF8(annotationText));
-	obs_data_set_string(event_data, "timestamp", QT_TO_UTF8(timestamp));
-	obs_data_set_string(event_data, "annotationSource", QT_TO_UTF8(annotationSource));
-	EmitWebSocketEvent("AnnotationSet", event_data);
+	obs_data_set_string(event_data, "annotationId", QT_TO_UTF8(annotationId));
+	obs_data_set_string(event_data, "timestamp", QT_TO_UTF8(formatRecordingTime(frameOffset)));
+	obs_data_set_string(event_data, "annotationSource", QT_TO_UTF8(annotationSource.webSocketName()));
+	EmitChapterEvent("AnnotationSet", event_data);
 	obs_data_release(event_data);
 }
 
@@ -1475,14 +2629,18 @@ void ChapterMarkerDock::setChapterMarkerFeedbackLabel(const QString &text, const
 }
 
 bool ChapterMarkerDock::writeToFile(const QString &filePath, const QString &content)
+{
+	return writeToFile(filePath, content.toUtf8());
+}
+
+bool ChapterMarkerDock::writeToFile(const QString &filePath, const QByteArray &content)
 {
 	QFile file(filePath);
 	if (!file.open(QIODevice::Append | QIODevice::Text)) {
 		return false;
 	}
 
-	QTextStream out(&file);
-	out << content;
+	file.write(content);
 	file.close();
 	return true;
 }
@@ -1497,7 +2655,7 @@ void ChapterMarkerDock::onSceneChanged()
 			if (scene_name) {
 				QString sceneName = QString::fromUtf8(scene_name);
 				if (!ignoredScenes.contains(sceneName)) {
-					addChapterMarker(sceneName, obs_module_text("ChangeScene"));
+					addChapterMarker(formatSceneChapterName(sceneName), MarkerSource::Kind::SceneChange);
 				}
 				obs_source_release(current_scene);
 			}
@@ -1505,67 +2663,362 @@ void ChapterMarkerDock::onSceneChanged()
 	}
 }
 
-extern bool (*obs_frontend_recording_add_chapter_wrapper)(const char *name);
+void ChapterMarkerDock::startSilenceDetection()
+{
+	silenceOnsetTimer.stop();
+	silenceDetector.detach();
+	if (!chapterOnSilenceEnabled || silenceSourceName.isEmpty()) {
+		return;
+	}
 
-void ChapterMarkerDock::addChapterMarker(const QString &chapterName, const QString &chapterSource)
+	SilenceDetector::Settings detectorSettings;
+	detectorSettings.silenceDb = static_cast<float>(silenceThresholdDb);
+	detectorSettings.speechDb = static_cast<float>(silenceThresholdDb + Constants::SILENCE_HYSTERESIS_DB);
+	detectorSettings.minSilenceMs = silenceMinSeconds * 1000;
+	detectorSettings.minSpeechMs = Constants::SILENCE_MIN_SPEECH_MS;
+	if (silenceDetector.attach(silenceSourceName, detectorSettings, recordingTimebase)) {
+		silenceOnsetTimer.start(Constants::SILENCE_ONSET_POLL_MS);
+	}
+}
+
+void ChapterMarkerDock::onSilenceOnsetTimer()
 {
-	QString fullChapterName = chapterName;
-	QString sourceText = " (" + chapterSource + ")";
+	uint64_t totalFrames;
+	while (silenceDetector.takeSpeechOnset(totalFrames)) {
+		if (obs_frontend_recording_active()) {
+			addChapterMarkerAt(formatDefaultChapterName(true), MarkerSource::Kind::Silence, receivedFrameOffset(totalFrames));
+		}
+	}
+}
 
+StringArena::Id ChapterMarkerDock::internFullChapterName(StringArena::Id name, StringArena::Id source)
+{
+	// Keyed by the id pair so repeat markers skip building the combined string
+	const quint64 key = (static_cast<quint64>(name) << 32) | (static_cast<quint64>(source) << 1) | (addChapterSourceEnabled ? 1 : 0);
+	const auto existing = fullChapterNameIds.constFind(key);
+	if (existing != fullChapterNameIds.constEnd()) {
+		return existing.value();
+	}
+
+	StringArena::Id fullName = name;
 	if (addChapterSourceEnabled) {
-		if (!fullChapterName.contains(sourceText)) {
-			fullChapterName += sourceText;
+		const QString sourceText = " (" + sessionStrings.text(source) + ")";
+		if (!sessionStrings.text(name).contains(sourceText)) {
+			fullName = sessionStrings.intern(sessionStrings.text(name) + sourceText);
 		}
 	}
+	fullChapterNameIds.insert(key, fullName);
+	return fullName;
+}
 
-	if (!isFirstRunInRecording && insertChapterMarkersInVideoEnabled) {
-		if (obs_frontend_recording_add_chapter_wrapper) {
-			bool success = obs_frontend_recording_add_chapter_wrapper(QT_TO_UTF8(fullChapterName));
-			if (!success) {
-				blog(LOG_INFO,
-				     "[StreamUP Record Chapter Manager] You have selected to insert chapters into video file. You are not using a compatible file type.");
-
-				if (!incompatibleFileTypeMessageShown) {
-					QMessageBox msgBox;
-					msgBox.setWindowTitle(obs_module_text("StreamUPChapterMarkerManagerError"));
-					msgBox.setIcon(QMessageBox::Warning);
-					msgBox.setText(obs_module_text("IncompatibleFileTypeError"));
-					msgBox.setInformativeText(obs_module_text("IncompatibleFileType"));
-					msgBox.setStandardButtons(QMessageBox::Ok);
-					msgBox.setDefaultButton(QMessageBox::Ok);
-					msgBox.exec();
-
-					incompatibleFileTypeMessageShown = true;
-				}
+void ChapterMarkerDock::clearSession()
+{
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Session held %d markers and %d distinct strings (%llu bytes)",
+	     static_cast<int>(sessionMarkers.size()), sessionStrings.count(), (unsigned long long)sessionStrings.bytesUsed());
+
+	// Ids die with the arena, drop everything that holds one first
+	deferredChapters.clear();
+	sessionMarkers.clear();
+	sessionAnnotations.clear();
+	lastWrittenFrameOffset = 0;
+	{
+		QMutexLocker locker(&publishedChaptersMutex);
+		publishedChapterList.clear();
+	}
+	fullChapterNameIds.clear();
+	sessionStrings.clear();
+	publishChapterState();
+}
+
+void ChapterMarkerDock::publishChapterState()
+{
+	const int markerId = lastLiveMarkerId();
+	if (markerId < 0) {
+		// Every chapter may have been deleted while the recording goes on
+		chapterState.publish(obs_frontend_recording_active(), -1, 0, 0, getCurrentRecordingMilliseconds(), QString());
+		return;
+	}
+
+	const SessionMarker &marker = sessionMarkers.at(markerId);
+	const auto chapterNumber = std::count_if(sessionMarkers.cbegin(), sessionMarkers.cend(),
+						 [](const SessionMarker &sessionMarker) { return !sessionMarker.deleted; });
+	chapterState.publish(true, markerId, static_cast<int>(chapterNumber),
+			     static_cast<qint64>(Timecode::framesToMilliseconds(marker.frameOffset, recordingTimebase)),
+			     getCurrentRecordingMilliseconds(), sessionStrings.text(marker.fullName));
+}
+
+QVector<PublishedChapter> ChapterMarkerDock::publishedChapters() const
+{
+	QMutexLocker locker(&publishedChaptersMutex);
+	return publishedChapterList;
+}
+
+bool ChapterMarkerDock::isPublishedChapterLive(int markerId) const
+{
+	QMutexLocker locker(&publishedChaptersMutex);
+	return markerId >= 0 && markerId < publishedChapterList.size() && !publishedChapterList.at(markerId).deleted;
+}
+
+bool ChapterMarkerDock::hasPublishedLiveChapter() const
+{
+	QMutexLocker locker(&publishedChaptersMutex);
+	return std::any_of(publishedChapterList.cbegin(), publishedChapterList.cend(),
+			   [](const PublishedChapter &chapter) { return !chapter.deleted; });
+}
+
+MarkerSource::Source ChapterMarkerDock::sessionMarkerSource(const SessionMarker &marker) const
+{
+	MarkerSource::Source source(marker.sourceKind);
+	if (marker.sourceKind == MarkerSource::Kind::Custom) {
+		source.customLabel = sessionStrings.text(marker.source);
+	}
+	return source;
+}
+
+QString ChapterMarkerDock::markerDisplayText(const SessionMarker &marker) const
+{
+	if (fullChapterHistoryEnabled) {
+		return formatRecordingTime(marker.frameOffset) + " - " + sessionStrings.text(marker.fullName);
+	}
+	return sessionStrings.text(marker.fullName);
+}
+
+int ChapterMarkerDock::lastLiveMarkerId() const
+{
+	for (int i = static_cast<int>(sessionMarkers.size()) - 1; i >= 0; --i) {
+		if (!sessionMarkers.at(i).deleted) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+bool ChapterMarkerDock::rewriteChapterMarker(int markerId, bool remove)
+{
+	// Each sidecar only rewrites from this marker onwards, chapters already inside the video stay as they are
+	const SessionMarker &marker = sessionMarkers.at(markerId);
+	const QString &chapterName = sessionStrings.text(marker.name);
+	const MarkerSource::Source chapterSource = sessionMarkerSource(marker);
+	bool ok = true;
+
+	if (textSidecar.hasMarker(markerId)) {
+		ok = textSidecar.replaceMarker(markerId, remove ? QByteArray()
+								: formatTextMarker(chapterName, marker.frameOffset, chapterSource)) &&
+		     ok;
+	}
+	if (fcpXmlSidecar.hasMarker(markerId)) {
+		ok = fcpXmlSidecar.replaceMarker(markerId, remove ? QByteArray()
+								  : formatFCPXMLMarker(chapterName, marker.frameOffset, chapterSource)) &&
+		     ok;
+	}
+	if (premiereXmlSidecar.hasMarker(markerId)) {
+		ok = premiereXmlSidecar.replaceMarker(
+			     markerId, remove ? QByteArray() : formatPremiereXMLMarker(chapterName, marker.frameOffset, chapterSource)) &&
+		     ok;
+	}
+	if (SidecarFile *edlFile = edlSidecarFor(markerId)) {
+		// Keep the event number, a removed event leaves a gap which EDL readers accept
+		const int eventNumberValue = edlFile->markerTag(markerId);
+		ok = edlFile->replaceMarker(markerId, remove ? QByteArray()
+							     : formatEDLMarker(chapterName, marker.frameOffset, chapterSource,
+									       eventNumberValue)) &&
+		     ok;
+	}
+	if (templateSidecar.hasMarker(markerId)) {
+		QByteArray rendered;
+		if (!remove) {
+			setTemplateFields(chapterName, marker.frameOffset, chapterSource.label());
+			templateFieldValues[ExportTemplate::FieldIndex] = QString::number(templateSidecar.markerTag(markerId));
+			rendered = renderTemplate(exportTemplate.marker);
+		}
+		ok = templateSidecar.replaceMarker(markerId, rendered) && ok;
+	}
+
+	if (chapterIndex.isOpen()) {
+		// A missing record is fine, the index may have been enabled after this marker
+		if (remove) {
+			chapterIndex.markDeleted(static_cast<uint32_t>(markerId));
+		} else {
+			chapterIndex.renameMarker(static_cast<uint32_t>(markerId), chapterName);
+		}
+	}
+
+	for (int i = 0; i < deferredChapters.size(); ++i) {
+		if (deferredChapters.at(i).markerId == markerId) {
+			if (remove) {
+				deferredChapters.removeAt(i);
+			} else {
+				deferredChapters[i].name = marker.fullName;
 			}
+			break;
 		}
-		auto ph = obs_get_proc_handler();
-		calldata cd;
-		calldata_init(&cd);
-		calldata_set_string(&cd, Constants::AITUM_VERTICAL_PARAM, QT_TO_UTF8(fullChapterName));
-		proc_handler_call(ph, Constants::AITUM_VERTICAL_PROC, &cd);
-		calldata_free(&cd);
-	} // Log and handle the result of adding the chapter marker
-	QString timestamp = getCurrentRecordingTime();
+	}
+	return ok;
+}
+
+void ChapterMarkerDock::updatePreviousChapterItem(int markerId, bool remove)
+{
+	for (int row = 0; row < previousChaptersList->count(); ++row) {
+		QListWidgetItem *item = previousChaptersList->item(row);
+		if (item->data(Qt::UserRole).toInt() != markerId) {
+			continue;
+		}
+		if (remove) {
+			delete previousChaptersList->takeItem(row);
+		} else {
+			item->setText(markerDisplayText(sessionMarkers.at(markerId)));
+		}
+		return;
+	}
+}
+
+bool ChapterMarkerDock::renameChapterMarker(int markerId, const QString &chapterName)
+{
+	if (markerId < 0 || markerId >= sessionMarkers.size() || sessionMarkers.at(markerId).deleted ||
+	    chapterName.trimmed().isEmpty()) {
+		return false;
+	}
+
+	SessionMarker &marker = sessionMarkers[markerId];
+	marker.name = sessionStrings.intern(chapterName.trimmed());
+	marker.fullName = internFullChapterName(marker.name, marker.source);
+	const bool ok = rewriteChapterMarker(markerId, false);
+	if (jsonLinesSidecar.isOpen()) {
+		jsonLinesSidecar.writeRename(markerId, sessionStrings.text(marker.name));
+	}
+	{
+		QMutexLocker locker(&publishedChaptersMutex);
+		publishedChapterList[markerId].chapterName = sessionStrings.text(marker.fullName);
+	}
+
+	updatePreviousChapterItem(markerId, false);
+	if (markerId == lastLiveMarkerId()) {
+		currentChapterName = sessionStrings.text(marker.fullName);
+		updateCurrentChapterLabel(currentChapterName);
+		publishChapterState();
+	}
+
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Renamed chapter marker %d to: %s", markerId,
+	     sessionStrings.utf8(marker.fullName));
+
+	obs_data_t *event_data = obs_data_create();
+	obs_data_set_int(event_data, "markerId", markerId);
+	obs_data_set_string(event_data, "chapterName", sessionStrings.utf8(marker.name));
+	EmitChapterEvent("ChapterMarkerRenamed", event_data);
+	obs_data_release(event_data);
+	return ok;
+}
+
+bool ChapterMarkerDock::deleteChapterMarker(int markerId)
+{
+	if (markerId < 0 || markerId >= sessionMarkers.size() || sessionMarkers.at(markerId).deleted) {
+		return false;
+	}
+
+	const bool wasLast = markerId == lastLiveMarkerId();
+	const bool ok = rewriteChapterMarker(markerId, true);
+	if (jsonLinesSidecar.isOpen()) {
+		jsonLinesSidecar.writeDelete(markerId);
+	}
+	sessionMarkers[markerId].deleted = true;
+	{
+		QMutexLocker locker(&publishedChaptersMutex);
+		publishedChapterList[markerId].deleted = true;
+	}
+
+	updatePreviousChapterItem(markerId, true);
+	const int previousId = lastLiveMarkerId();
+	if (wasLast && previousId >= 0) {
+		currentChapterName = sessionStrings.text(sessionMarkers.at(previousId).fullName);
+		updateCurrentChapterLabel(currentChapterName);
+	}
+	// The chapter number counts live markers, so any delete changes it
+	publishChapterState();
+
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Removed chapter marker %d: %s", markerId,
+	     sessionStrings.utf8(sessionMarkers.at(markerId).fullName));
+
+	obs_data_t *event_data = obs_data_create();
+	obs_data_set_int(event_data, "markerId", markerId);
+	EmitChapterEvent("ChapterMarkerDeleted", event_data);
+	obs_data_release(event_data);
+	return ok;
+}
+
+void ChapterMarkerDock::addChapterMarker(const QString &chapterName, const MarkerSource::Source &chapterSource)
+{
+	// Sample the recording position once, every export formats the same frame
+	addChapterMarkerAt(chapterName, chapterSource, getCurrentRecordingFrame());
+}
+
+void ChapterMarkerDock::addChapterMarkerAt(const QString &chapterName, const MarkerSource::Source &chapterSource,
+					   uint64_t frameOffset)
+{
+	// Scene, preset and source names repeat all session, each is converted and stored once
+	const StringArena::Id nameId = sessionStrings.intern(chapterName);
+	const StringArena::Id sourceId = sessionStrings.intern(chapterSource.label());
+	const StringArena::Id fullNameId = internFullChapterName(nameId, sourceId);
+	const QString fullChapterName = sessionStrings.text(fullNameId);
+	const char *fullChapterNameUtf8 = sessionStrings.utf8(fullNameId);
+	const int markerId = static_cast<int>(sessionMarkers.size());
+	sessionMarkers.append({frameOffset, chapterSource.kind, nameId, sourceId, fullNameId, false});
+	lastWrittenFrameOffset = std::max(lastWrittenFrameOffset, frameOffset);
+	{
+		QMutexLocker locker(&publishedChaptersMutex);
+		publishedChapterList.append(
+			{markerId, static_cast<qint64>(Timecode::framesToMilliseconds(frameOffset, recordingTimebase)), fullChapterName, false});
+	}
+
+	if (insertChapterMarkersInVideoEnabled) {
+		// The first marker of a recording lines up with the chapter OBS inserts itself
+		if (inContainerChaptersSupported && !isFirstRunInRecording) {
+			if (!obs_frontend_recording_add_chapter_wrapper(fullChapterNameUtf8)) {
+				// The probe let this output through but it still refused, stop trying for this recording
+				disableInContainerChapters();
+			}
+		}
+
+		if (!inContainerChaptersSupported && deferInContainerChaptersEnabled) {
+			deferredChapters.append({markerId,
+						 static_cast<qint64>(Timecode::framesToMilliseconds(frameOffset, recordingTimebase)),
+						 fullNameId});
+		}
+	}
+
+	if (!isFirstRunInRecording && insertChapterMarkersInVideoEnabled) {
+		chapterFanout.dispatch(fullChapterNameUtf8);
+	}
 
 	// Always write to the chapter file if enabled
 	if (exportChaptersToTextEnabled) {
-		writeChapterToTextFile(chapterName, timestamp, chapterSource);
+		writeChapterToTextFile(chapterName, frameOffset, chapterSource, markerId);
 	}
 
 	if (exportChaptersToFCPXMLEnabled) {
-		writeChapterToFCPXMLFile(chapterName, timestamp, chapterSource);
+		writeChapterToFCPXMLFile(chapterName, frameOffset, chapterSource, markerId);
 	}
 
 	if (exportChaptersToPremiereXMLEnabled) {
-		writeChapterToPremiereXMLFile(chapterName, timestamp, chapterSource);
+		writeChapterToPremiereXMLFile(chapterName, frameOffset, chapterSource, markerId);
 	}
 
 	if (exportChaptersToEDLEnabled) {
-		writeChapterToEDLFile(chapterName, timestamp, chapterSource);
+		writeChapterToEDLFile(chapterName, frameOffset, chapterSource, markerId);
+	}
+
+	if (exportChaptersToTemplateEnabled) {
+		writeChapterToTemplateFile(chapterName, frameOffset, chapterSource, false, QString(), markerId);
+	}
+
+	if (exportChaptersToIndexEnabled) {
+		writeToChapterIndex(frameOffset, markerId, chapterSource, 0, chapterName);
+	}
+
+	if (jsonLinesSidecar.isOpen()) {
+		jsonLinesSidecar.writeMarker(false, markerId, frameOffset, chapterName, chapterSource.webSocketName());
 	}
 
-	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Added chapter marker: %s", QT_TO_UTF8(fullChapterName));
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Added chapter marker: %s", fullChapterNameUtf8);
 
 	updateCurrentChapterLabel(fullChapterName);
 	QString feedbackMessage = QString("%1 %2").arg(obs_module_text("NewChapter")).arg(fullChapterName);
@@ -1573,27 +3026,27 @@ void ChapterMarkerDock::addChapterMarker(const QString &chapterName, const QStri
 
 	// Update the global current chapter name
 	currentChapterName = fullChapterName;
+	publishChapterState();
 
-	// Move the chapter to the top of the previous chapters list
-	QString displayText = fullChapterName;
-	if (fullChapterHistoryEnabled) {
-		displayText = timestamp + " - " + fullChapterName;
-	}
+	// Move the chapter to the top of the previous chapters list, the item edits the newest marker with that text
+	const QString displayText = markerDisplayText(sessionMarkers.last());
 
 	QList<QListWidgetItem *> items = previousChaptersList->findItems(displayText, Qt::MatchExactly);
 	if (!items.isEmpty()) {
 		delete previousChaptersList->takeItem(previousChaptersList->row(items.first()));
 	}
-	previousChaptersList->insertItem(0, displayText);
-
-	chapters.insert(0, chapterName);
-	timestamps.insert(0, timestamp);
+	QListWidgetItem *item = new QListWidgetItem(displayText);
+	item->setData(Qt::UserRole, markerId);
+	previousChaptersList->insertItem(0, item);
 
 	// Emit WebSocket event for the new chapter marker
 	obs_data_t *event_data = obs_data_create();
-	obs_data_set_string(event_data, "chapterName", QT_TO_UTF8(chapterName));
-	obs_data_set_string(event_data, "chapterSource", QT_TO_UTF8(chapterSource));
-	EmitWebSocketEvent("ChapterMarkerSet", event_data);
+	obs_data_set_int(event_data, "markerId", markerId);
+	obs_data_set_string(event_data, "chapterName", sessionStrings.utf8(nameId));
+	obs_data_set_string(event_data, "chapterSource",
+			    chapterSource.kind == MarkerSource::Kind::Custom ? sessionStrings.utf8(sourceId)
+									     : chapterSource.info().webSocketName);
+	EmitChapterEvent("ChapterMarkerSet", event_data);
 	obs_data_release(event_data);
 
 	// After the first run, set the flag to false
@@ -1602,12 +3055,82 @@ void ChapterMarkerDock::addChapterMarker(const QString &chapterName, const QStri
 
 void ChapterMarkerDock::onAddChapterMarker(const QString &chapterName, const QString &chapterSource)
 {
-	addChapterMarker(chapterName, chapterSource);
+	// Requests without a name get the default name here on the UI thread, where the count lives
+	if (chapterName.isEmpty()) {
+		addChapterMarker(formatDefaultChapterName(true), MarkerSource::Source::fromWebSocketName(chapterSource));
+		return;
+	}
+	addChapterMarker(chapterName, MarkerSource::Source::fromWebSocketName(chapterSource));
+}
+
+uint64_t ChapterMarkerDock::receivedFrameOffset(quint64 totalFrames) const
+{
+	// The exports expect markers in order, a cue that raced a newer chapter or annotation lands on the same frame
+	const uint64_t frameOffset = totalFrames > recordingStartFrameCount ? totalFrames - recordingStartFrameCount : 0;
+	return std::max(frameOffset, lastWrittenFrameOffset);
+}
+
+void ChapterMarkerDock::onOscChapterReceived(const QString &chapterName, quint64 totalFrames)
+{
+	if (!obs_frontend_recording_active()) {
+		return;
+	}
+	const QString name = chapterName.trimmed().isEmpty() ? formatDefaultChapterName(true) : chapterName.trimmed();
+	addChapterMarkerAt(name, MarkerSource::Kind::Osc, receivedFrameOffset(totalFrames));
+}
+
+void ChapterMarkerDock::onOscAnnotationReceived(const QString &annotationText, quint64 totalFrames)
+{
+	writeAnnotationToFiles(annotationText, receivedFrameOffset(totalFrames), MarkerSource::Kind::Osc);
+}
+
+void ChapterMarkerDock::onOscPresetChapterReceived(int presetNumber, quint64 totalFrames)
+{
+	if (!obs_frontend_recording_active()) {
+		return;
+	}
+	if (presetNumber < 1 || presetNumber > presetChapters.size()) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] OSC asked for preset chapter %d, there are %d", presetNumber,
+		     static_cast<int>(presetChapters.size()));
+		return;
+	}
+	addChapterMarkerAt(presetChapters.at(presetNumber - 1), MarkerSource::Kind::Osc, receivedFrameOffset(totalFrames));
 }
 
 void ChapterMarkerDock::onAddAnnotation(const QString &annotationText, const QString &annotationSource)
 {
-	writeAnnotationToFiles(annotationText, getCurrentRecordingTime(), annotationSource);
+	writeAnnotationToFiles(annotationText, getCurrentRecordingFrame(), MarkerSource::Source::fromWebSocketName(annotationSource));
+}
+
+void ChapterMarkerDock::onRenameChapterMarker(int markerId, const QString &chapterName)
+{
+	if (renameChapterMarker(markerId, chapterName)) {
+		showFeedbackMessage(QString("%1 %2").arg(obs_module_text("ChapterMarkerRenamed"), chapterName.trimmed()), false);
+	} else {
+		showFeedbackMessage(obs_module_text("ChapterMarkerEditFailed"), true);
+	}
+}
+
+void ChapterMarkerDock::onDeleteChapterMarker(int markerId)
+{
+	if (deleteChapterMarker(markerId)) {
+		showFeedbackMessage(QString("%1 %2").arg(obs_module_text("ChapterMarkerDeleted"),
+							 sessionStrings.text(sessionMarkers.at(markerId).fullName)),
+				    false);
+	} else {
+		showFeedbackMessage(obs_module_text("ChapterMarkerEditFailed"), true);
+	}
+}
+
+void ChapterMarkerDock::onUndoLastChapterMarker()
+{
+	// The newest marker is at the end of every file, removing it is a truncate
+	const int markerId = lastLiveMarkerId();
+	if (markerId < 0) {
+		showFeedbackMessage(obs_module_text("ChapterMarkerNothingToUndo"), true);
+		return;
+	}
+	onDeleteChapterMarker(markerId);
 }
 
 //--------------------UTILITY FUNCTIONS--------------------
@@ -1625,6 +3148,58 @@ void ChapterMarkerDock::applyThemeIDToButton(QPushButton *button, const QString
 	button->style()->polish(button);
 }
 
+QString ChapterMarkerDock::formatDefaultChapterName(bool withCount)
+{
+	return formatChapterName(chapterNameTemplate, QString(), withCount);
+}
+
+QString ChapterMarkerDock::formatSceneChapterName(const QString &sceneName)
+{
+	return formatChapterName(sceneChapterNameTemplate, sceneName,
+				 sceneChapterNameTemplate.usesField(ChapterNameTemplate::FieldNumber));
+}
+
+QString ChapterMarkerDock::formatChapterName(const TextTemplate &nameTemplate, const QString &sceneName, bool withCount)
+{
+	chapterNameFieldValues[ChapterNameTemplate::FieldName] = defaultChapterName;
+	if (withCount) {
+		chapterNameFieldValues[ChapterNameTemplate::FieldNumber].setNum(chapterCount);
+		chapterCount++;
+	} else {
+		chapterNameFieldValues[ChapterNameTemplate::FieldNumber].resize(0);
+	}
+
+	// Look up the remaining fields only when the template uses them
+	if (nameTemplate.usesField(ChapterNameTemplate::FieldScene)) {
+		if (!sceneName.isEmpty()) {
+			chapterNameFieldValues[ChapterNameTemplate::FieldScene] = sceneName;
+		} else {
+			obs_source_t *current_scene = obs_frontend_get_current_scene();
+			chapterNameFieldValues[ChapterNameTemplate::FieldScene] =
+				current_scene ? QString::fromUtf8(obs_source_get_name(current_scene)) : QString();
+			obs_source_release(current_scene);
+		}
+	}
+	if (nameTemplate.usesField(ChapterNameTemplate::FieldTime)) {
+		chapterNameFieldValues[ChapterNameTemplate::FieldTime] = getCurrentRecordingTime();
+	}
+	if (nameTemplate.usesField(ChapterNameTemplate::FieldDate)) {
+		chapterNameFieldValues[ChapterNameTemplate::FieldDate] = QDate::currentDate().toString(Qt::ISODate);
+	}
+
+	QString chapterName;
+	nameTemplate.render(chapterName, chapterNameFieldValues);
+
+	// Drop the separator left behind by an empty {count}
+	while (!chapterName.isEmpty() && chapterName.back().isSpace()) {
+		chapterName.chop(1);
+	}
+	if (chapterName.isEmpty()) {
+		chapterName = defaultChapterName;
+	}
+	return chapterName;
+}
+
 QString ChapterMarkerDock::getChapterName() const
 {
 	return chapterNameInput->text();
@@ -1636,32 +3211,43 @@ void ChapterMarkerDock::resetRecordingStartFrameCount()
 	// This allows us to calculate timestamps relative to the recording start
 	recordingStartFrameCount = obs_get_total_frames();
 	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Recording started at frame: %llu", (unsigned long long)recordingStartFrameCount);
+
+	// Both clocks are sampled with the frame count so other instances' sessions can be lined up with this one
+	recordingStartAnchor.monotonicNs = os_gettime_ns();
+	recordingStartAnchor.wallClockNs =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	// The timebase is fixed while recording, formatters use this copy instead of asking OBS per marker
+	obs_video_info ovi;
+	recordingTimebase = Timecode::Timebase();
+	if (obs_get_video_info(&ovi) && ovi.fps_num > 0 && ovi.fps_den > 0) {
+		recordingTimebase.fpsNum = ovi.fps_num;
+		recordingTimebase.fpsDen = ovi.fps_den;
+	}
 }
 
-QString ChapterMarkerDock::getCurrentRecordingTime() const
+uint64_t ChapterMarkerDock::getCurrentRecordingFrame() const
 {
 	// Use obs_get_total_frames() to get the live capture frame count
 	// instead of obs_output_get_total_frames() which returns the encoder's
 	// output frame count (which lags 1-2 seconds behind due to buffering)
-	const uint64_t currentFrames = obs_get_total_frames();
+	return obs_get_total_frames() - recordingStartFrameCount;
+}
 
-	// Calculate frames elapsed since recording started
-	const uint64_t framesElapsed = currentFrames - recordingStartFrameCount;
+qint64 ChapterMarkerDock::getCurrentRecordingMilliseconds() const
+{
+	return static_cast<qint64>(Timecode::framesToMilliseconds(getCurrentRecordingFrame(), recordingTimebase));
+}
 
-	obs_video_info ovi;
-	QString recordingTimeString = Constants::DEFAULT_TIMESTAMP;
-
-	if (obs_get_video_info(&ovi)) {
-		const double frameRate = static_cast<double>(ovi.fps_num) / ovi.fps_den;
-		if (frameRate > 0.0) {
-			const uint64_t totalSeconds = static_cast<uint64_t>(framesElapsed / frameRate);
-			QTime recordingTime(0, 0, 0);
-			recordingTime = recordingTime.addSecs(totalSeconds);
-			recordingTimeString = recordingTime.toString("HH:mm:ss");
-		}
-	}
+QString ChapterMarkerDock::formatRecordingTime(uint64_t frameOffset) const
+{
+	char buffer[Timecode::BUFFER_SIZE];
+	return QString::fromLatin1(buffer, static_cast<qsizetype>(Timecode::formatHms(buffer, frameOffset, recordingTimebase)));
+}
 
-	return recordingTimeString;
+QString ChapterMarkerDock::getCurrentRecordingTime() const
+{
+	return formatRecordingTime(getCurrentRecordingFrame());
 }
 
 //--------------------CONFIGS--------------------
@@ -1671,9 +3257,35 @@ void ChapterMarkerDock::LoadSettings(obs_data_t *settings)
 	defaultChapterName = QString::fromUtf8(obs_data_get_string(settings, "defaultChapterName"));
 	useIncrementalChapterNames = obs_data_get_bool(settings, "useIncrementalChapterNames");
 
+	// Chapter name templates, compiled once here and reused by every trigger
+	obs_data_set_default_string(settings, "chapterNameTemplate", Constants::DEFAULT_CHAPTER_NAME_TEMPLATE);
+	obs_data_set_default_string(settings, "sceneChapterNameTemplate", Constants::DEFAULT_SCENE_CHAPTER_NAME_TEMPLATE);
+	chapterNameTemplateSource = QString::fromUtf8(obs_data_get_string(settings, "chapterNameTemplate"));
+	sceneChapterNameTemplateSource = QString::fromUtf8(obs_data_get_string(settings, "sceneChapterNameTemplate"));
+	if (!chapterNameTemplate.compile(chapterNameTemplateSource, ChapterNameTemplate::fieldNames())) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Template: %s", QT_TO_UTF8(chapterNameTemplate.errorString()));
+	}
+	if (!sceneChapterNameTemplate.compile(sceneChapterNameTemplateSource, ChapterNameTemplate::fieldNames())) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Template: %s",
+		     QT_TO_UTF8(sceneChapterNameTemplate.errorString()));
+	}
+
 	// Set chapter on scene change
 	chapterOnSceneChangeEnabled = obs_data_get_bool(settings, "chapterOnSceneChangeEnabled");
 
+	// Silence chapters, a change made while recording applies at once
+	obs_data_set_default_int(settings, "silenceThresholdDb", Constants::DEFAULT_SILENCE_THRESHOLD_DB);
+	obs_data_set_default_int(settings, "silenceMinSeconds", Constants::DEFAULT_SILENCE_MIN_SECONDS);
+	chapterOnSilenceEnabled = obs_data_get_bool(settings, "chapterOnSilenceEnabled");
+	silenceSourceName = QString::fromUtf8(obs_data_get_string(settings, "silenceSourceName"));
+	silenceThresholdDb = std::clamp(static_cast<int>(obs_data_get_int(settings, "silenceThresholdDb")),
+					Constants::MIN_SILENCE_THRESHOLD_DB, -Constants::SILENCE_HYSTERESIS_DB);
+	silenceMinSeconds =
+		std::clamp(static_cast<int>(obs_data_get_int(settings, "silenceMinSeconds")), 1, Constants::MAX_SILENCE_MIN_SECONDS);
+	if (obs_frontend_recording_active()) {
+		startSilenceDetection();
+	}
+
 	// Previous chapters
 	showPreviousChaptersEnabled = obs_data_get_bool(settings, "showPreviousChaptersEnabled");
 	fullChapterHistoryEnabled = obs_data_get_bool(settings, "fullChapterHistoryEnabled");
@@ -1684,9 +3296,76 @@ void ChapterMarkerDock::LoadSettings(obs_data_t *settings)
 	exportChaptersToFCPXMLEnabled = obs_data_get_bool(settings, "exportChaptersToFCPXmlEnabled");
 	exportChaptersToPremiereXMLEnabled = obs_data_get_bool(settings, "exportChaptersToPremiereXmlEnabled");
 	exportChaptersToEDLEnabled = obs_data_get_bool(settings, "exportChaptersToEDLEnabled");
+	exportChaptersToIndexEnabled = obs_data_get_bool(settings, "exportChaptersToIndexEnabled");
+	exportChaptersToJsonLinesEnabled = obs_data_get_bool(settings, "exportChaptersToJsonLinesEnabled");
+	obs_data_set_default_string(settings, "jsonLinesDurability", "interval");
+	obs_data_set_default_int(settings, "jsonLinesSyncEvery", Constants::DEFAULT_JSON_LINES_SYNC_INTERVAL_MS);
+	const QString durabilityName = QString::fromUtf8(obs_data_get_string(settings, "jsonLinesDurability"));
+	jsonLinesDurability = durabilityName == "none"	  ? JsonLinesSidecar::Durability::None
+			      : durabilityName == "records" ? JsonLinesSidecar::Durability::EveryRecords
+							    : JsonLinesSidecar::Durability::Interval;
+	jsonLinesSyncEvery = std::clamp(static_cast<int>(obs_data_get_int(settings, "jsonLinesSyncEvery")), 1,
+					Constants::MAX_JSON_LINES_SYNC_EVERY);
+	exportChaptersToTemplateEnabled = obs_data_get_bool(settings, "exportChaptersToTemplateEnabled");
+	stageExportFilesEnabled = obs_data_get_bool(settings, "stageExportFilesEnabled");
+	exportStagingDirectory = QString::fromUtf8(obs_data_get_string(settings, "exportStagingDirectory"));
+
+	// Custom export template, compiled once here rather than per marker
+	obs_data_set_default_string(settings, "exportTemplateFileSuffix", Constants::TEMPLATE_FILE_SUFFIX);
+	obs_data_set_default_string(settings, "exportTemplateMarker", Constants::DEFAULT_TEMPLATE_LINE);
+	obs_data_set_default_string(settings, "exportTemplateAnnotation", Constants::DEFAULT_TEMPLATE_LINE);
+	exportTemplate.fileSuffix = QString::fromUtf8(obs_data_get_string(settings, "exportTemplateFileSuffix"));
+	if (!ExportTemplate::isValidFileSuffix(exportTemplate.fileSuffix)) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Template file suffix ignored: %s",
+		     QT_TO_UTF8(exportTemplate.fileSuffix));
+		exportTemplate.fileSuffix = Constants::TEMPLATE_FILE_SUFFIX;
+	}
+	exportTemplate.escapeName = QString::fromUtf8(obs_data_get_string(settings, "exportTemplateEscape"));
+	exportTemplate.headerSource = QString::fromUtf8(obs_data_get_string(settings, "exportTemplateHeader"));
+	exportTemplate.markerSource = QString::fromUtf8(obs_data_get_string(settings, "exportTemplateMarker"));
+	exportTemplate.annotationSource = QString::fromUtf8(obs_data_get_string(settings, "exportTemplateAnnotation"));
+	exportTemplate.footerSource = QString::fromUtf8(obs_data_get_string(settings, "exportTemplateFooter"));
+	if (!exportTemplate.compile()) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Template: %s", QT_TO_UTF8(exportTemplate.errorString()));
+	}
 
 	// Write chapters to video
 	insertChapterMarkersInVideoEnabled = obs_data_get_bool(settings, "insertChapterMarkersInVideoEnabled");
+	deferInContainerChaptersEnabled = obs_data_get_bool(settings, "deferInContainerChaptersEnabled");
+	obs_data_set_default_string(settings, "chapterTargets", Constants::AITUM_VERTICAL_PROC);
+	chapterFanout.setTargets(ChapterFanout::parseTargets(QString::fromUtf8(obs_data_get_string(settings, "chapterTargets"))));
+
+	// Webhook endpoints, the sender thread only starts once there is one
+	QStringList webhookUrls;
+	obs_data_array_t *webhookUrlsArray = obs_data_get_array(settings, "webhookUrls");
+	if (webhookUrlsArray) {
+		for (size_t i = 0; i < obs_data_array_count(webhookUrlsArray); ++i) {
+			obs_data_t *urlData = obs_data_array_item(webhookUrlsArray, i);
+			webhookUrls << QString::fromUtf8(obs_data_get_string(urlData, "url"));
+			obs_data_release(urlData);
+		}
+		obs_data_array_release(webhookUrlsArray);
+	}
+	webhookSender.setEndpoints(webhookUrls);
+
+	// OSC listener
+	obs_data_set_default_int(settings, "oscListenerPort", Constants::DEFAULT_OSC_PORT);
+	oscListenerEnabled = obs_data_get_bool(settings, "oscListenerEnabled");
+	oscListenerPort = static_cast<int>(obs_data_get_int(settings, "oscListenerPort"));
+	oscListenerAllInterfaces = obs_data_get_bool(settings, "oscListenerAllInterfaces");
+	if (oscListenerEnabled) {
+		oscListener.startListening(static_cast<quint16>(oscListenerPort), oscListenerAllInterfaces);
+	} else {
+		oscListener.stopListening();
+	}
+
+	// Local event feed
+	eventFeedEnabled = obs_data_get_bool(settings, "eventFeedEnabled");
+	if (eventFeedEnabled) {
+		eventFeed.start(Constants::EVENT_FEED_SERVER_NAME);
+	} else {
+		eventFeed.stop();
+	}
 
 	// Add chapter source
 	addChapterSourceEnabled = obs_data_get_bool(settings, "addChapterSourceEnabled");
@@ -1717,9 +3396,19 @@ void ChapterMarkerDock::SaveSettings()
 			    defaultChapterNameEdit->text().isEmpty() ? obs_module_text("Chapter")
 								     : defaultChapterNameEdit->text().toStdString().c_str());
 	obs_data_set_bool(settings, "useIncrementalChapterNames", useIncrementalChapterNames);
+	obs_data_set_string(settings, "chapterNameTemplate",
+			    chapterNameTemplateEdit->text().isEmpty() ? Constants::DEFAULT_CHAPTER_NAME_TEMPLATE
+								      : QT_TO_UTF8(chapterNameTemplateEdit->text()));
+	obs_data_set_string(settings, "sceneChapterNameTemplate",
+			    sceneChapterNameTemplateEdit->text().isEmpty() ? Constants::DEFAULT_SCENE_CHAPTER_NAME_TEMPLATE
+									   : QT_TO_UTF8(sceneChapterNameTemplateEdit->text()));
 
 	// Set chapter on scene change
 	obs_data_set_bool(settings, "chapterOnSceneChangeEnabled", chapterOnSceneChangeCheckbox->isChecked());
+	obs_data_set_bool(settings, "chapterOnSilenceEnabled", chapterOnSilenceCheckbox->isChecked());
+	obs_data_set_string(settings, "silenceSourceName", QT_TO_UTF8(silenceSourceCombo->currentText()));
+	obs_data_set_int(settings, "silenceThresholdDb", silenceThresholdSpinBox->value());
+	obs_data_set_int(settings, "silenceMinSeconds", silenceMinSecondsSpinBox->value());
 
 	// Previous chapters
 	obs_data_set_bool(settings, "showPreviousChaptersEnabled", showPreviousChaptersCheckbox->isChecked());
@@ -1731,9 +3420,54 @@ void ChapterMarkerDock::SaveSettings()
 	obs_data_set_bool(settings, "exportChaptersToFCPXmlEnabled", exportChaptersToFCPXMLCheckbox->isChecked());
 	obs_data_set_bool(settings, "exportChaptersToPremiereXmlEnabled", exportChaptersToPremiereXMLCheckbox->isChecked());
 	obs_data_set_bool(settings, "exportChaptersToEDLEnabled", exportChaptersToEDLCheckbox->isChecked());
+	obs_data_set_bool(settings, "exportChaptersToIndexEnabled", exportChaptersToIndexCheckbox->isChecked());
+	obs_data_set_bool(settings, "exportChaptersToJsonLinesEnabled", exportChaptersToJsonLinesCheckbox->isChecked());
+	switch (static_cast<JsonLinesSidecar::Durability>(jsonLinesDurabilityCombo->currentData().toInt())) {
+	case JsonLinesSidecar::Durability::None:
+		obs_data_set_string(settings, "jsonLinesDurability", "none");
+		break;
+	case JsonLinesSidecar::Durability::EveryRecords:
+		obs_data_set_string(settings, "jsonLinesDurability", "records");
+		break;
+	case JsonLinesSidecar::Durability::Interval:
+		obs_data_set_string(settings, "jsonLinesDurability", "interval");
+		break;
+	}
+	obs_data_set_int(settings, "jsonLinesSyncEvery", jsonLinesSyncEverySpinBox->value());
+	obs_data_set_bool(settings, "exportChaptersToTemplateEnabled", exportChaptersToTemplateCheckbox->isChecked());
+	obs_data_set_bool(settings, "stageExportFilesEnabled", stageExportFilesCheckbox->isChecked());
+	obs_data_set_string(settings, "exportStagingDirectory", QT_TO_UTF8(exportStagingDirectoryEdit->text().trimmed()));
+
+	// Custom export template
+	obs_data_set_string(settings, "exportTemplateFileSuffix", QT_TO_UTF8(exportTemplate.fileSuffix));
+	obs_data_set_string(settings, "exportTemplateEscape", QT_TO_UTF8(exportTemplate.escapeName));
+	obs_data_set_string(settings, "exportTemplateHeader", QT_TO_UTF8(exportTemplate.headerSource));
+	obs_data_set_string(settings, "exportTemplateMarker", QT_TO_UTF8(exportTemplate.markerSource));
+	obs_data_set_string(settings, "exportTemplateAnnotation", QT_TO_UTF8(exportTemplate.annotationSource));
+	obs_data_set_string(settings, "exportTemplateFooter", QT_TO_UTF8(exportTemplate.footerSource));
 
 	// Write chapters to video
 	obs_data_set_bool(settings, "insertChapterMarkersInVideoEnabled", insertChapterMarkersCheckbox->isChecked());
+	obs_data_set_bool(settings, "deferInContainerChaptersEnabled", deferInContainerChaptersCheckbox->isChecked());
+	obs_data_set_string(settings, "chapterTargets", QT_TO_UTF8(ChapterFanout::parseTargets(chapterTargetsEdit->text()).join(", ")));
+
+	obs_data_array_t *webhookUrlsArray = obs_data_array_create();
+	for (const QString &url : webhookSender.endpoints()) {
+		obs_data_t *urlData = obs_data_create();
+		obs_data_set_string(urlData, "url", QT_TO_UTF8(url));
+		obs_data_array_push_back(webhookUrlsArray, urlData);
+		obs_data_release(urlData);
+	}
+	obs_data_set_array(settings, "webhookUrls", webhookUrlsArray);
+	obs_data_array_release(webhookUrlsArray);
+
+	// OSC listener
+	obs_data_set_bool(settings, "oscListenerEnabled", oscListenerCheckbox->isChecked());
+	obs_data_set_int(settings, "oscListenerPort", oscListenerPortSpinBox->value());
+	obs_data_set_bool(settings, "oscListenerAllInterfaces", oscListenerAllInterfacesCheckbox->isChecked());
+
+	// Local event feed
+	obs_data_set_bool(settings, "eventFeedEnabled", eventFeedCheckbox->isChecked());
 
 	// Add chapter source
 	obs_data_set_bool(settings, "addChapterSourceEnabled", addChapterSourceCheckbox->isChecked());
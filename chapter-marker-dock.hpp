@@ -3,8 +3,24 @@
 #ifndef CHAPTER_MARKER_DOCK_HPP
 #define CHAPTER_MARKER_DOCK_HPP
 
+#include "annotation-store.hpp"
+#include "chapter-fanout.hpp"
+#include "chapter-index.hpp"
+#include "chapter-state.hpp"
+#include "event-feed.hpp"
+#include "json-lines-sidecar.hpp"
+#include "marker-source.hpp"
+#include "osc-listener.hpp"
+#include "session-catalog.hpp"
+#include "sidecar-file.hpp"
+#include "silence-detector.hpp"
+#include "string-arena.hpp"
+#include "text-template.hpp"
+#include "timecode-format.hpp"
+#include "webhook-sender.hpp"
 #include <obs-frontend-api.h>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QDialog>
 #include <QFrame>
 #include <QGroupBox>
@@ -12,14 +28,57 @@
 #include <QLineEdit>
 #include <QListWidget>
 #include <QMap>
+#include <QMutex>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QStringList>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVBoxLayout>
+#include <QVector>
+#include <functional>
 
 // Forward declaration of AnnotationDock
 class AnnotationDock;
 
+// Chapter held back for post-processing when the recording container cannot take chapters
+struct DeferredChapter {
+	int markerId;
+	qint64 timeMs;
+	StringArena::Id name;
+};
+
+// File work left when a recording stops, everything it needs is captured so it can run on the finalize pool
+struct FinalizeTask {
+	const char *format = nullptr; // Stable name reported in the ChapterFilesFinalized event
+	QString filePath;
+	std::function<bool()> write;
+};
+
+struct FinalizeResult {
+	const char *format;
+	QString filePath;
+	bool success;
+};
+
+// Marker of the current recording, names live in the session string arena
+struct SessionMarker {
+	uint64_t frameOffset;
+	MarkerSource::Kind sourceKind;
+	StringArena::Id name;
+	StringArena::Id source;
+	StringArena::Id fullName;
+	bool deleted;
+};
+
+// Copy of a session marker that native procs read from any thread
+struct PublishedChapter {
+	int markerId;
+	qint64 timeMs;
+	QString chapterName;
+	bool deleted;
+};
+
 class ChapterMarkerDock : public QFrame {
 	Q_OBJECT
 
@@ -32,35 +91,73 @@ public:
 	void setExportTextFilePath(const QString &filePath);
 	void setExportFCPXMLFilePath(const QString &filePath);
 	void setExportPremiereXMLFilePath(const QString &filePath);
-	void writeChapterToFCPXMLFile(const QString &chapterName, const QString &timestamp, const QString &chapterSource);
-	void writeChapterToPremiereXMLFile(const QString &chapterName, const QString &timestamp, const QString &chapterSource);
+	void writeChapterToFCPXMLFile(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+				      int markerId = -1);
+	void writeChapterToPremiereXMLFile(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+					   int markerId = -1);
 	void closeFCPXMLFile();
 	void closePremiereXMLFile();
+	void writeChapterToTemplateFile(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+					bool isAnnotation, const QString &annotationId = QString(), int markerId = -1);
+	FinalizeTask closeTemplateFile(uint64_t endFrame);
+
+	AnnotationStore annotationStore;
+	SessionCatalog sessionCatalog;
+	ChapterFanout chapterFanout;
+	WebhookSender webhookSender;
+	EventFeed eventFeed;
 
 	QString getDefaultChapterName() const { return defaultChapterName; }
+	QString formatDefaultChapterName(bool withCount);
+	QString formatSceneChapterName(const QString &sceneName);
 
 	QString getCurrentRecordingTime() const;
+	uint64_t getCurrentRecordingFrame() const;
+	qint64 getCurrentRecordingMilliseconds() const;
+	QString formatRecordingTime(uint64_t frameOffset) const;
 	void updateCurrentChapterLabel(const QString &chapterName);
 	void createExportFiles();
+	void resetExportFiles();
 	void showFeedbackMessage(const QString &message, bool isError);
 	void clearPreviousChaptersGroup();
-	void writeChapterToTextFile(const QString &chapterName, const QString &timestamp, const QString &chapterSource);
-	void writeChapterToEDLFile(const QString &chapterName, const QString &timestamp, const QString &chapterSource);
+	void writeChapterToTextFile(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+				    int markerId = -1);
+	void writeChapterToEDLFile(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+				   int markerId = -1);
 	void setExportEDLFilePath(const QString &filePath);
-	QString convertTimestampToTimecode(const QString &timestamp, int frameNumber) const;
-	void addChapterMarker(const QString &chapterName, const QString &chapterSource);
+	void addChapterMarker(const QString &chapterName, const MarkerSource::Source &chapterSource);
+	// For triggers that sampled the frame when they arrived
+	void addChapterMarkerAt(const QString &chapterName, const MarkerSource::Source &chapterSource, uint64_t frameOffset);
+	bool renameChapterMarker(int markerId, const QString &chapterName);
+	bool deleteChapterMarker(int markerId);
+	QVector<PublishedChapter> publishedChapters() const;
+	// Safe from any thread, edits checked here can still lose a race and are checked again on the UI thread
+	bool isPublishedChapterLive(int markerId) const;
+	bool hasPublishedLiveChapter() const;
 	bool exportChaptersToTextEnabled;
 	bool exportChaptersToFCPXMLEnabled;
 	bool exportChaptersToPremiereXMLEnabled;
 	bool exportChaptersToEDLEnabled;
+	bool exportChaptersToIndexEnabled;
+	bool exportChaptersToJsonLinesEnabled;
+	bool stageExportFilesEnabled;
+	QString exportStagingDirectory;
+	bool exportChaptersToTemplateEnabled;
 	bool exportChaptersToFileEnabled;
 	bool insertChapterMarkersInVideoEnabled;
+	bool deferInContainerChaptersEnabled;
+	bool inContainerChaptersSupported;
 	QString exportTextFilePath;
 	QString exportFCPXMLFilePath;
 	QString exportPremiereXMLFilePath;
 	QString exportEDLFilePath;
+	QString exportTemplateFilePath;
+	ExportTemplate exportTemplate;
 	QString defaultChapterName;
+	QString chapterNameTemplateSource;
+	QString sceneChapterNameTemplateSource;
 	int edlEventNumber;
+	int edlPartNumber;
 	int fcpMarkerID;
 	QStringList ignoredScenes;
 	bool chapterOnSceneChangeEnabled;
@@ -71,7 +168,7 @@ public:
 	bool useIncrementalChapterNames;
 
 	void setAnnotationDock(AnnotationDock *dock);
-	void writeAnnotationToFiles(const QString &chapterName, const QString &timestamp, const QString &chapterSource);
+	void writeAnnotationToFiles(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource);
 	void applyThemeIDToButton(QPushButton *button, const QString &themeID);
 	QDialog *settingsDialog;
 	void LoadSettings(obs_data_t *settings);
@@ -84,12 +181,22 @@ public:
 	QMap<QString, obs_hotkey_id> chapterHotkeys;
 	void onAddChapterMarker(const QString &chapterName, const QString &chapterSource);
 	void onAddAnnotation(const QString &annotationText, const QString &annotationSource);
+	void onRenameChapterMarker(int markerId, const QString &chapterName);
+	void onDeleteChapterMarker(int markerId);
+	void onUndoLastChapterMarker();
 	void resetRecordingStartFrameCount(); // Reset the frame count when recording starts
 	uint64_t recordingStartFrameCount; // Track the frame count when recording started
+	Timecode::Timebase recordingTimebase; // Video frame rate cached when recording starts
+	ChapterIndex::SessionAnchor recordingStartAnchor; // Clock times of frame 0, written to the chapter index
+	void probeInContainerChapterSupport(); // Detect once per recording whether the output can take chapters
+	void startSilenceDetection(); // Attach to the chosen audio source for this recording
 
 signals:
 	void addChapterMarkerSignal(const QString &chapterName, const QString &chapterSource);
 	void addAnnotationSignal(const QString &annotationText, const QString &annotationSource);
+	void renameChapterMarkerSignal(int markerId, const QString &chapterName);
+	void deleteChapterMarkerSignal(int markerId);
+	void undoLastChapterMarkerSignal();
 
 public slots:
 	void onAddChapterMarkerButton();
@@ -100,16 +207,22 @@ public slots:
 	void onRecordingStopped();
 	void onPreviousChapterSelected();
 	void onPreviousChapterDoubleClicked(QListWidgetItem *item);
+	void onPreviousChaptersContextMenu(const QPoint &position);
 	void saveSettingsAndCloseDialog();
 	void refreshMainDockUI();
 	void onSetPresetChaptersButtonClicked();
 	void onSetIgnoredScenesClicked();
+	void onEditExportTemplateClicked();
+	void onSearchRecordingsClicked();
+	void onEditWebhooksClicked();
 
 private:
 	void setupPresetChaptersDialog();
 	void registerChapterHotkey(const QString &chapterName);
 	void unregisterChapterHotkey(const QString &chapterName);
 	QDialog *presetChaptersDialog;
+	QPushButton *searchRecordingsButton;
+	QPushButton *webhooksButton;
 	QLineEdit *presetChapterNameInput;
 	QPushButton *addChapterButton;
 	QPushButton *removeChapterButton;
@@ -132,14 +245,30 @@ private:
 	QCheckBox *exportChaptersToFCPXMLCheckbox;
 	QCheckBox *exportChaptersToPremiereXMLCheckbox;
 	QCheckBox *exportChaptersToEDLCheckbox;
+	QCheckBox *exportChaptersToIndexCheckbox;
+	QCheckBox *exportChaptersToJsonLinesCheckbox;
+	QComboBox *jsonLinesDurabilityCombo;
+	QSpinBox *jsonLinesSyncEverySpinBox;
+	QCheckBox *stageExportFilesCheckbox;
+	QLineEdit *exportStagingDirectoryEdit;
+	QPushButton *exportStagingBrowseButton;
+	QCheckBox *exportChaptersToTemplateCheckbox;
+	QPushButton *editExportTemplateButton;
 	QGroupBox *exportSettingsGroup;
 	QCheckBox *insertChapterMarkersCheckbox;
+	QCheckBox *deferInContainerChaptersCheckbox;
+	QHBoxLayout *deferInContainerChaptersLayout;
+	QLabel *chapterTargetsLabel;
+	QLineEdit *chapterTargetsEdit;
+	QHBoxLayout *chapterTargetsLayout;
 	void setupSettingsExportGroup(QVBoxLayout *mainLayout);
 	void onExportChaptersToFileToggled(bool checked);
 	void onChapterOnSceneChangeToggled(bool checked);
+	void onInsertChapterMarkersToggled(bool checked);
 
 	void setAnnotationFeedbackLabel(const QString &text, const QString &themeID);
 	bool writeToFile(const QString &filePath, const QString &content);
+	bool writeToFile(const QString &filePath, const QByteArray &content);
 	void setChapterMarkerFeedbackLabel(const QString &text, const QString &themeID);
 
 	QDialog *createIgnoredScenesUI();
@@ -162,6 +291,8 @@ private:
 	QPushButton *saveChapterMarkerButton;
 
 	QLineEdit *defaultChapterNameEdit;
+	QLineEdit *chapterNameTemplateEdit;
+	QLineEdit *sceneChapterNameTemplateEdit;
 	QCheckBox *showPreviousChaptersCheckbox;
 	QCheckBox *fullChapterHistoryCheckbox;
 	QCheckBox *addChapterSourceCheckbox;
@@ -169,15 +300,143 @@ private:
 	QListWidget *ignoredScenesListWidget;
 	QGroupBox *ignoredScenesGroup;
 
-	QStringList chapters;
-	QStringList timestamps;
+	StringArena sessionStrings;
+	QHash<quint64, StringArena::Id> fullChapterNameIds;
+	QVector<SessionMarker> sessionMarkers;
+	uint64_t lastWrittenFrameOffset; // Latest chapter or annotation in the exports, which must stay sorted by frame
+	StringArena::Id internFullChapterName(StringArena::Id name, StringArena::Id source);
+	void clearSession();
+	MarkerSource::Source sessionMarkerSource(const SessionMarker &marker) const;
+	QString markerDisplayText(const SessionMarker &marker) const;
+	int lastLiveMarkerId() const;
+	bool rewriteChapterMarker(int markerId, bool remove);
+	void updatePreviousChapterItem(int markerId, bool remove);
+
+	// Byte ranges of every marker written this recording, used to edit them in place
+	SidecarFile textSidecar;
+	SidecarFile fcpXmlSidecar;
+	SidecarFile premiereXmlSidecar;
+	SidecarFile edlSidecar;
+	QVector<SidecarFile> finishedEdlSidecars; // Earlier EDL parts of this recording, markers in them stay editable
+	SidecarFile *edlSidecarFor(int markerId);
+	SidecarFile templateSidecar;
+	// Append-only, edits are written as records of their own
+	JsonLinesSidecar jsonLinesSidecar;
+	JsonLinesSidecar::Durability jsonLinesDurability;
+	int jsonLinesSyncEvery; // Records or milliseconds, depending on the durability
+	QTimer jsonLinesSyncTimer;
+	QByteArray formatTextMarker(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource) const;
+	QByteArray formatFCPXMLMarker(const QString &chapterName, uint64_t frameOffset,
+				      const MarkerSource::Source &chapterSource) const;
+	QByteArray formatPremiereXMLMarker(const QString &chapterName, uint64_t frameOffset,
+					   const MarkerSource::Source &chapterSource) const;
+	QByteArray formatEDLMarker(const QString &chapterName, uint64_t frameOffset, const MarkerSource::Source &chapterSource,
+				   int eventNumberValue) const;
 
 	QHBoxLayout *textCheckboxLayout;
 	QHBoxLayout *fcpXmlCheckboxLayout;
 	QHBoxLayout *premiereXmlCheckboxLayout;
 	QHBoxLayout *edlCheckboxLayout;
+	QHBoxLayout *indexCheckboxLayout;
+	QHBoxLayout *jsonLinesCheckboxLayout;
+	QHBoxLayout *stagingLayout;
+	QHBoxLayout *templateCheckboxLayout;
 	QVBoxLayout *exportSettingsLayout;
-	bool incompatibleFileTypeMessageShown = false;
+
+	QDialog *createExportTemplateUI();
+	QDialog *exportTemplateDialog;
+	QDialog *createWebhooksUI();
+	QDialog *webhooksDialog;
+	void setTemplateFields(const QString &name, uint64_t frameOffset, const QString &source);
+	QByteArray renderTemplate(const TextTemplate &textTemplate);
+	QString formatChapterName(const TextTemplate &nameTemplate, const QString &sceneName, bool withCount);
+	TextTemplate chapterNameTemplate;
+	TextTemplate sceneChapterNameTemplate;
+	QString chapterNameFieldValues[ChapterNameTemplate::FieldCount];
+
+	QString templateFieldValues[ExportTemplate::FieldCount];
+	QByteArray templateRenderBuffer;
+	int templateMarkerIndex;
+
+	bool createEDLFile(const QString &edlFilePath, const QString &title);
+	bool rollOverEDLFile(uint64_t frameOffset);
+	QString edlFileBasePath;
+
+	ChapterIndexWriter chapterIndex;
+	void writeToChapterIndex(uint64_t frameOffset, int markerId, const MarkerSource::Source &chapterSource, uint8_t flags,
+				 const QString &name);
+
+	void disableInContainerChapters();
+	FinalizeTask finalizeDeferredChaptersFile();
+
+	QThreadPool finalizePool;
+	static void appendFinalizeTask(QVector<FinalizeTask> &tasks, FinalizeTask task);
+	void startFinalizeTasks(const QVector<FinalizeTask> &tasks);
+
+	// Set by the first createExportFiles of a recording, cleared when it stops
+	QString exportDirectoryPath;
+	// Set while this recording's files are written to the staging folder
+	QString activeStagingDirectory;
+	QString stagedRecordingDirectory;
+	QString stagedBaseName;
+	void appendStagedFileMoves(QVector<FinalizeTask> &tasks);
+	const char *stagedFileFormat(const QString &stagedPath) const;
+	void onExportFilesFinalized(const QVector<FinalizeResult> &results, qint64 elapsedMs);
+	QString deferredChaptersFilePath;
+	QVector<DeferredChapter> deferredChapters;
+
+	// Finished recordings are catalogued and older ones backfilled on this pool, it never blocks a recording
+	QThreadPool catalogPool;
+	QVector<SessionCatalog::Entry> sessionAnnotations;
+	void openSessionCatalog();
+	void addSessionToCatalog();
+	void startCatalogBackfill(const QString &folderPath);
+	void onCatalogBackfillFinished(int addedCount);
+	QDialog *createRecordingSearchUI();
+	void updateRecordingSearchResults();
+
+	QDialog *recordingSearchDialog;
+	QLineEdit *recordingSearchEdit;
+	QListWidget *recordingSearchResults;
+	QLabel *recordingSearchStatusLabel;
+	QPushButton *recordingSearchIndexButton;
+
+	// Written on the UI thread next to sessionMarkers, indexed by marker id
+	mutable QMutex publishedChaptersMutex;
+	QVector<PublishedChapter> publishedChapterList;
+
+	// Control surfaces send cues over OSC, the frame travels with the signal from the listener thread
+	OscListener oscListener;
+	bool oscListenerEnabled;
+	int oscListenerPort;
+	QCheckBox *oscListenerCheckbox;
+	QSpinBox *oscListenerPortSpinBox;
+	bool oscListenerAllInterfaces;
+	QCheckBox *oscListenerAllInterfacesCheckbox;
+	uint64_t receivedFrameOffset(quint64 totalFrames) const;
+	void onOscChapterReceived(const QString &chapterName, quint64 totalFrames);
+	void onOscAnnotationReceived(const QString &annotationText, quint64 totalFrames);
+	void onOscPresetChapterReceived(int presetNumber, quint64 totalFrames);
+
+	bool eventFeedEnabled;
+	QCheckBox *eventFeedCheckbox;
+
+	// Overlays read the current chapter from shared memory instead of polling the WebSocket
+	ChapterState::Publisher chapterState;
+	void publishChapterState();
+
+	// Speech after a long silence on one audio source starts a chapter, onsets are collected from the audio thread
+	SilenceDetector silenceDetector;
+	QTimer silenceOnsetTimer;
+	bool chapterOnSilenceEnabled;
+	QString silenceSourceName;
+	int silenceThresholdDb;
+	int silenceMinSeconds;
+	QCheckBox *chapterOnSilenceCheckbox;
+	QComboBox *silenceSourceCombo;
+	QSpinBox *silenceThresholdSpinBox;
+	QSpinBox *silenceMinSecondsSpinBox;
+	void onSilenceOnsetTimer();
 };
 
 #endif // CHAPTER_MARKER_DOCK_HPP
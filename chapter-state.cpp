@@ -0,0 +1,153 @@
+#include "chapter-state.hpp"
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace ChapterState {
+
+namespace {
+
+constexpr int READ_ATTEMPTS = 64;
+
+} // namespace
+
+bool read(const Block *block, Snapshot &out)
+{
+	if (!block || block->magic != MAGIC || block->version != VERSION) {
+		return false;
+	}
+
+	for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+		const uint32_t before = block->sequence.load(std::memory_order_acquire);
+		if (before & 1) {
+			continue; // The writer is in the middle of an update
+		}
+		Payload payload;
+		memcpy(&payload, &block->payload, sizeof(payload));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (block->sequence.load(std::memory_order_relaxed) != before) {
+			continue;
+		}
+
+		out.sequence = before;
+		out.recording = payload.recording != 0;
+		out.markerId = payload.markerId;
+		out.chapterNumber = payload.chapterNumber;
+		out.chapterStartMs = payload.chapterStartMs;
+		out.recordingStartedAtMs = payload.recordingStartedAtMs;
+		const int nameBytes = static_cast<int>(std::min<uint32_t>(payload.nameBytes, MAX_NAME_BYTES));
+		out.chapterName = QString::fromUtf8(payload.chapterName, nameBytes);
+		return true;
+	}
+	return false;
+}
+
+void setKey(QSharedMemory &memory, const QString &key)
+{
+	// Writer and readers must derive the native key the same way
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+	memory.setNativeKey(QSharedMemory::legacyNativeKey(key));
+#else
+	memory.setKey(key);
+#endif
+}
+
+Publisher::~Publisher()
+{
+	close();
+}
+
+bool Publisher::open(const QString &key)
+{
+	close();
+	errorText.clear();
+
+	// The seqlock allows one writer, a lock held by a running process means another OBS instance publishes
+	writerLock = std::make_unique<QLockFile>(QDir::temp().filePath(key + ".lock"));
+	writerLock->setStaleLockTime(0); // Stale only once the owning process has exited
+	if (!writerLock->tryLock(0)) {
+		errorText = writerLock->error() == QLockFile::LockFailedError ? QString("another OBS instance already publishes it")
+									  : QString("the writer lock file could not be created");
+		writerLock.reset();
+		return false;
+	}
+
+	// With the lock held, a block that already exists was left behind by a writer that is gone, for example after a crash
+	setKey(memory, key);
+	if (!memory.create(sizeof(Block)) && (memory.error() != QSharedMemory::AlreadyExists || !memory.attach())) {
+		errorText = memory.errorString();
+		writerLock.reset();
+		return false;
+	}
+	if (memory.size() < static_cast<qsizetype>(sizeof(Block))) {
+		errorText = "the existing block is too small";
+		memory.detach();
+		writerLock.reset();
+		return false;
+	}
+
+	block = new (memory.data()) Block;
+	block->magic = MAGIC;
+	block->version = VERSION;
+	block->sequence.store(0, std::memory_order_relaxed);
+	block->reserved = 0;
+	memset(&block->payload, 0, sizeof(block->payload));
+	block->payload.markerId = -1;
+	wasRecording = false;
+	return true;
+}
+
+void Publisher::close()
+{
+	if (!block) {
+		return;
+	}
+	// Readers that stay attached see a stopped recording rather than a stale chapter
+	publish(false, -1, 0, 0, 0, QString());
+	block = nullptr;
+	memory.detach();
+	writerLock.reset();
+}
+
+void Publisher::publish(bool recording, int markerId, int chapterNumber, qint64 chapterStartMs, qint64 recordingMs,
+			const QString &chapterName)
+{
+	if (!block) {
+		return;
+	}
+
+	// The start time is taken once so readers can count up a clock that does not drift
+	Payload &payload = block->payload;
+	const qint64 recordingStartedAtMs = !recording ? 0
+					    : wasRecording ? payload.recordingStartedAtMs
+							   : QDateTime::currentMSecsSinceEpoch() - recordingMs;
+	wasRecording = recording;
+
+	QByteArray name = recording ? chapterName.toUtf8() : QByteArray();
+	if (name.size() > MAX_NAME_BYTES) {
+		int cut = MAX_NAME_BYTES;
+		while (cut > 0 && (static_cast<unsigned char>(name.at(cut)) & 0xC0) == 0x80) {
+			--cut;
+		}
+		name.truncate(cut);
+	}
+
+	const uint32_t sequence = block->sequence.load(std::memory_order_relaxed);
+	block->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	payload.recording = recording ? 1 : 0;
+	payload.markerId = recording ? markerId : -1;
+	payload.chapterNumber = recording ? chapterNumber : 0;
+	payload.chapterStartMs = recording ? chapterStartMs : 0;
+	payload.recordingStartedAtMs = recordingStartedAtMs;
+	payload.nameBytes = static_cast<uint32_t>(name.size());
+	memcpy(payload.chapterName, name.constData(), static_cast<size_t>(name.size()));
+
+	block->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+} // namespace ChapterState
@@ -0,0 +1,99 @@
+#pragma once
+
+#ifndef CHAPTER_STATE_HPP
+#define CHAPTER_STATE_HPP
+
+#include <QLockFile>
+#include <QSharedMemory>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @namespace ChapterState
+ * @brief Current chapter published in a shared memory block for local readers
+ *
+ * Overlays that only want to show the current chapter can map the block and
+ * read it instead of polling getCurrentChapterMarker over WebSocket. The
+ * plugin is the only writer and updates the block whenever the current
+ * chapter or the recording state changes. A lock file next to the key makes
+ * sure of that across processes: a second OBS instance does not publish, and
+ * a block is only taken over when the process that wrote it is gone.
+ *
+ * The block is guarded by a seqlock: the writer makes the sequence odd,
+ * rewrites the payload and makes it even again. A reader copies the payload
+ * between two reads of the sequence and keeps the copy when both reads are
+ * the same even number, so readers never block the writer or each other.
+ * The sequence also tells a polling reader whether anything changed.
+ *
+ * The layout is fixed size and native endian. MAGIC and VERSION come first
+ * so a reader can tell a block it does not understand.
+ */
+namespace ChapterState {
+
+constexpr uint32_t MAGIC = 0x53434850; // "SCHP"
+constexpr uint32_t VERSION = 1;
+constexpr int MAX_NAME_BYTES = 512; // UTF-8, longer names are cut on a character boundary
+
+struct Payload {
+	uint32_t recording; // 1 while a recording is running
+	int32_t markerId; // Marker id of the current chapter, -1 before the first one
+	int32_t chapterNumber; // 1-based position among the chapters that were not deleted
+	uint32_t nameBytes;
+	int64_t chapterStartMs; // Start of the current chapter, from the start of the recording
+	int64_t recordingStartedAtMs; // Wall clock, milliseconds since the epoch
+	char chapterName[MAX_NAME_BYTES];
+};
+
+struct Block {
+	uint32_t magic;
+	uint32_t version;
+	std::atomic<uint32_t> sequence;
+	uint32_t reserved;
+	Payload payload;
+};
+
+struct Snapshot {
+	uint32_t sequence = 0;
+	bool recording = false;
+	int markerId = -1;
+	int chapterNumber = 0;
+	qint64 chapterStartMs = 0;
+	qint64 recordingStartedAtMs = 0;
+	QString chapterName;
+};
+
+// Gives up after a few attempts when the writer keeps changing the block
+bool read(const Block *block, Snapshot &out);
+
+void setKey(QSharedMemory &memory, const QString &key);
+
+/**
+ * @class Publisher
+ * @brief Owns the shared memory block and is its only writer
+ */
+class Publisher {
+public:
+	~Publisher();
+
+	// Fails while another live process holds the writer lock for the key
+	bool open(const QString &key);
+	void close();
+	const QString &errorString() const { return errorText; }
+
+	// Chapter fields are ignored while not recording
+	void publish(bool recording, int markerId, int chapterNumber, qint64 chapterStartMs, qint64 recordingMs,
+		     const QString &chapterName);
+
+private:
+	std::unique_ptr<QLockFile> writerLock;
+	QSharedMemory memory;
+	Block *block = nullptr;
+	bool wasRecording = false;
+	QString errorText;
+};
+
+} // namespace ChapterState
+
+#endif // CHAPTER_STATE_HPP
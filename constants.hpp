@@ -21,12 +21,35 @@ namespace Constants {
 	constexpr const char *DEFAULT_CHAPTER_NAME = "Chapter";
 	constexpr const char *DEFAULT_TIMESTAMP = "00:00:00";
 	constexpr int DEFAULT_CHAPTER_COUNT = 1;
+	constexpr const char *DEFAULT_CHAPTER_NAME_TEMPLATE = "{name} {count}";
+	constexpr const char *DEFAULT_SCENE_CHAPTER_NAME_TEMPLATE = "{scene}";
+	constexpr const char *DEFAULT_TEMPLATE_LINE = "{time} - {name}";
+
+	// Annotations are exported as a short title, the body lives in the annotation store
+	constexpr int ANNOTATION_TITLE_LENGTH = 48;
+
+	// CMX3600 EDL event numbers are limited to three digits
+	constexpr int EDL_MAX_EVENTS = 999;
+
+	// Export files are finished in parallel when the recording stops
+	constexpr int FINALIZE_MAX_THREADS = 4;
 
 	// File extensions
 	constexpr const char *TEXT_FILE_SUFFIX = "_chapters.txt";
 	constexpr const char *FCPXML_FILE_SUFFIX = "_chapters_fcp.xml";
 	constexpr const char *PREMIEREXML_FILE_SUFFIX = "_chapters_premiere.xml";
 	constexpr const char *EDL_FILE_SUFFIX = "_chapters.edl";
+	constexpr const char *TEMPLATE_FILE_SUFFIX = "_chapters_custom.txt";
+	constexpr const char *EDL_MANIFEST_FILE_SUFFIX = "_chapters_edl_parts.txt";
+	constexpr const char *FFMETADATA_FILE_SUFFIX = "_chapters.ffmetadata";
+	constexpr const char *ANNOTATION_STORE_FILE_SUFFIX = "_annotations.txt";
+	constexpr const char *CHAPTER_INDEX_FILE_SUFFIX = "_chapters.chidx";
+	constexpr const char *JSON_LINES_FILE_SUFFIX = "_chapters.jsonl";
+
+	// JSON Lines durability
+	constexpr int DEFAULT_JSON_LINES_SYNC_RECORDS = 1;
+	constexpr int DEFAULT_JSON_LINES_SYNC_INTERVAL_MS = 1000;
+	constexpr int MAX_JSON_LINES_SYNC_EVERY = 600000;
 
 	// Theme IDs
 	constexpr const char *THEME_ERROR = "error";
@@ -38,6 +61,8 @@ namespace Constants {
 	constexpr const char *CHAPTER_MARKER_DOCK_ID = "ChapterMarkerDock";
 	constexpr const char *ANNOTATION_DOCK_ID = "AnnotationDock";
 	constexpr const char *CONFIG_FILE_NAME = "configs.json";
+	constexpr const char *SESSION_CATALOG_FILE_NAME = "session-catalog.jsonl";
+	constexpr const char *WEBHOOK_SPOOL_FILE_NAME = "webhook-spool.jsonl";
 
 	// WebSocket events
 	constexpr const char *WS_EVENT_CHAPTER_SET = "ChapterMarkerSet";
@@ -47,10 +72,49 @@ namespace Constants {
 	constexpr const char *WS_REQUEST_SET_CHAPTER = "setChapterMarker";
 	constexpr const char *WS_REQUEST_GET_CHAPTER = "getCurrentChapterMarker";
 	constexpr const char *WS_REQUEST_SET_ANNOTATION = "setAnnotation";
+	constexpr const char *WS_REQUEST_GET_ANNOTATION = "getAnnotation";
+	constexpr const char *WS_REQUEST_RENAME_CHAPTER = "renameChapterMarker";
+	constexpr const char *WS_REQUEST_DELETE_CHAPTER = "deleteChapterMarker";
+	constexpr const char *WS_REQUEST_UNDO_CHAPTER = "undoLastChapterMarker";
+	constexpr const char *WS_REQUEST_SEARCH_RECORDINGS = "searchRecordings";
 
 	// Hotkey names
 	constexpr const char *HOTKEY_ADD_DEFAULT_CHAPTER = "addDefaultChapterMarker";
 
+	// Recording outputs that accept in-video chapters
+	constexpr const char *HYBRID_MP4_OUTPUT_ID = "mp4_output";
+	constexpr const char *HYBRID_MOV_OUTPUT_ID = "mov_output";
+
+	// Native procs on the global proc handler, for scripts and other plugins
+	constexpr const char *PROC_ADD_CHAPTER =
+		"void streamup_chapter_add(in string chapter_name, in string chapter_source, out bool success)";
+	constexpr const char *PROC_ADD_ANNOTATION =
+		"void streamup_chapter_add_annotation(in string annotation_text, in string annotation_source, out bool success)";
+	constexpr const char *PROC_GET_CURRENT_CHAPTER =
+		"void streamup_chapter_get_current(out string chapter_name, out int marker_id, out int time_ms, out bool success)";
+	constexpr const char *PROC_GET_CHAPTER_HISTORY =
+		"void streamup_chapter_get_history(out string chapters_json, out int count, out bool success)";
+
+	// Silence chapters, speech has to reach the threshold plus the hysteresis
+	constexpr int DEFAULT_SILENCE_THRESHOLD_DB = -45;
+	constexpr int MIN_SILENCE_THRESHOLD_DB = -90;
+	constexpr int SILENCE_HYSTERESIS_DB = 10;
+	constexpr int DEFAULT_SILENCE_MIN_SECONDS = 3;
+	constexpr int MAX_SILENCE_MIN_SECONDS = 600;
+	constexpr int SILENCE_MIN_SPEECH_MS = 250;
+	constexpr int SILENCE_ONSET_POLL_MS = 100;
+
+	// OSC listener for control surfaces
+	constexpr int DEFAULT_OSC_PORT = 9000;
+
+	// Local socket, /tmp/<name> on Linux and macOS, \\.\pipe\<name> on Windows
+	constexpr const char *EVENT_FEED_SERVER_NAME = "streamup-chapter-events";
+	// How long a live feed under the same name gets to answer before its socket file counts as stale
+	constexpr int EVENT_FEED_PROBE_TIMEOUT_MS = 250;
+
+	// Shared memory block with the current chapter, read by streamup-chapter-state
+	constexpr const char *CHAPTER_STATE_KEY = "streamup-chapter-state";
+
 	// Aitum Vertical integration
 	constexpr const char *AITUM_VERTICAL_PROC = "aitum_vertical_add_chapter";
 	constexpr const char *AITUM_VERTICAL_PARAM = "chapter_name";
@@ -0,0 +1,146 @@
+#include "event-feed.hpp"
+#include "constants.hpp"
+#include <obs-module.h>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QVector>
+
+EventFeed::~EventFeed()
+{
+	stop();
+}
+
+void EventFeed::start(const QString &serverName)
+{
+	if (thread.isRunning() && serverName == name) {
+		return;
+	}
+	stop();
+
+	name = serverName;
+	thread.start();
+	context = new QObject;
+	context->moveToThread(&thread);
+	QMetaObject::invokeMethod(context, [this, serverName]() { listen(serverName); });
+	accepting.storeRelaxed(1);
+}
+
+void EventFeed::stop()
+{
+	if (!thread.isRunning()) {
+		return;
+	}
+
+	// Sockets are closed on the thread they belong to, context has nothing left to own afterwards
+	accepting.storeRelaxed(0);
+	QMetaObject::invokeMethod(context, [this]() { close(); }, Qt::BlockingQueuedConnection);
+	thread.quit();
+	thread.wait();
+	delete context;
+	context = nullptr;
+}
+
+void EventFeed::post(const char *eventType, const char *eventJson)
+{
+	// Nothing is built while the feed is off
+	if (!accepting.loadRelaxed()) {
+		return;
+	}
+
+	QJsonObject object{{"eventType", QString::fromUtf8(eventType)}, {"timestampMs", QDateTime::currentMSecsSinceEpoch()}};
+	object.insert("eventData", QJsonDocument::fromJson(QByteArray(eventJson ? eventJson : "{}")).object());
+	QByteArray line = QJsonDocument(object).toJson(QJsonDocument::Compact);
+	line.append('\n');
+	QMetaObject::invokeMethod(context, [this, line]() { broadcast(line); });
+}
+
+void EventFeed::listen(const QString &serverName)
+{
+	server = new QLocalServer;
+	server->setSocketOptions(QLocalServer::UserAccessOption);
+	QObject::connect(server, &QLocalServer::newConnection, context, [this]() { acceptSubscribers(); });
+
+	// A name that still answers belongs to another running OBS, taking it over would cut off its subscribers
+	QLocalSocket probe;
+	probe.connectToServer(serverName);
+	if (probe.waitForConnected(Constants::EVENT_FEED_PROBE_TIMEOUT_MS)) {
+		probe.abort();
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] The event feed %s is already in use by another process",
+		     serverName.toUtf8().constData());
+		return;
+	}
+
+	// Nothing answered, a socket file left behind by a crash would make listen() fail on Unix
+	QLocalServer::removeServer(serverName);
+	if (!server->listen(serverName)) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not open the event feed %s: %s",
+		     serverName.toUtf8().constData(), server->errorString().toUtf8().constData());
+		return;
+	}
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Streaming chapter events on %s",
+	     server->fullServerName().toUtf8().constData());
+}
+
+void EventFeed::close()
+{
+	const QList<QLocalSocket *> subscribers = laggedEvents.keys();
+	laggedEvents.clear();
+	for (QLocalSocket *socket : subscribers) {
+		socket->disconnect(context);
+		socket->abort();
+		delete socket;
+	}
+	delete server;
+	server = nullptr;
+}
+
+void EventFeed::acceptSubscribers()
+{
+	while (QLocalSocket *socket = server->nextPendingConnection()) {
+		// The server stays the parent so close() reaches sockets that have not said anything yet
+		laggedEvents.insert(socket, 0);
+		QObject::connect(socket, &QLocalSocket::disconnected, context, [this, socket]() {
+			laggedEvents.remove(socket);
+			socket->deleteLater();
+		});
+		// Subscribers only read, anything they send is thrown away
+		QObject::connect(socket, &QLocalSocket::readyRead, context, [socket]() { socket->readAll(); });
+	}
+}
+
+void EventFeed::broadcast(const QByteArray &line)
+{
+	QVector<QLocalSocket *> tooSlow;
+	for (auto it = laggedEvents.begin(); it != laggedEvents.end(); ++it) {
+		QLocalSocket *socket = it.key();
+		qint64 &lagged = it.value();
+
+		if (socket->bytesToWrite() + line.size() > MAX_BUFFERED_BYTES) {
+			if (++lagged > MAX_LAGGED_EVENTS) {
+				tooSlow.append(socket);
+			}
+			continue;
+		}
+
+		if (lagged > 0) {
+			const QJsonObject dropped{{"eventType", "EventsDropped"},
+						  {"timestampMs", QDateTime::currentMSecsSinceEpoch()},
+						  {"eventData", QJsonObject{{"count", lagged}}}};
+			socket->write(QJsonDocument(dropped).toJson(QJsonDocument::Compact).append('\n'));
+			lagged = 0;
+		}
+		socket->write(line);
+	}
+
+	// Aborting can emit disconnected, which edits the subscriber list
+	for (QLocalSocket *socket : tooSlow) {
+		blog(LOG_INFO, "[StreamUP Record Chapter Manager] Disconnected an event feed subscriber that stopped reading");
+		socket->abort();
+		if (laggedEvents.remove(socket)) {
+			socket->deleteLater();
+		}
+	}
+}
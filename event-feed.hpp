@@ -0,0 +1,62 @@
+#pragma once
+
+#ifndef EVENT_FEED_HPP
+#define EVENT_FEED_HPP
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QThread>
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * @class EventFeed
+ * @brief Streams chapter and session events to local processes over a local socket
+ *
+ * The server is a QLocalServer, a Unix domain socket on Linux and macOS and a
+ * named pipe on Windows, so an overlay or a logging agent only has to connect
+ * and read lines instead of speaking WebSocket. Every event is one line of
+ * compact JSON, the same object the webhooks send:
+ *   {"eventType":"ChapterMarkerSet","timestampMs":...,"eventData":{...}}
+ *
+ * The server and its subscribers live on their own thread and post() only
+ * queues the event there. Each subscriber has at most MAX_BUFFERED_BYTES
+ * waiting to be written. A subscriber that reads too slowly misses events
+ * until it catches up and then gets an EventsDropped line with the count.
+ * One that falls more than MAX_LAGGED_EVENTS behind is disconnected.
+ */
+class EventFeed {
+public:
+	static constexpr qint64 MAX_BUFFERED_BYTES = 256 * 1024; // Per subscriber
+	static constexpr qint64 MAX_LAGGED_EVENTS = 1000;
+
+	~EventFeed();
+
+	// Restarts the server when the name changes
+	void start(const QString &serverName);
+	void stop();
+	bool isRunning() const { return thread.isRunning(); }
+
+	// Called where the other event sinks are, returns at once
+	void post(const char *eventType, const char *eventJson);
+
+private:
+	// These run on the feed thread
+	void listen(const QString &serverName);
+	void close();
+	void acceptSubscribers();
+	void broadcast(const QByteArray &line);
+
+	QThread thread;
+	QString name;
+	QObject *context = nullptr; // Lives on the feed thread, queued calls run there
+	QAtomicInteger<int> accepting = 0;
+
+	QLocalServer *server = nullptr;
+	QHash<QLocalSocket *, qint64> laggedEvents; // Events each subscriber missed since its last write
+};
+
+#endif // EVENT_FEED_HPP
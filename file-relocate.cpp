@@ -0,0 +1,102 @@
+#include "file-relocate.hpp"
+#include <obs-module.h>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QStorageInfo>
+#include <filesystem>
+#include <system_error>
+
+#define QT_TO_UTF8(str) str.toUtf8().constData()
+
+namespace FileRelocate {
+
+namespace {
+
+constexpr qint64 COPY_CHUNK_SIZE = 1024 * 1024;
+constexpr const char *PARTIAL_SUFFIX = ".partial";
+
+bool hashFile(const QString &path, QByteArray &out)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+
+	QCryptographicHash hash(QCryptographicHash::Sha256);
+	if (!hash.addData(&file)) {
+		return false;
+	}
+	out = hash.result();
+	return true;
+}
+
+bool copyVerified(const QString &sourcePath, const QString &partialPath)
+{
+	QFile source(sourcePath);
+	QFile partial(partialPath);
+	if (!source.open(QIODevice::ReadOnly) || !partial.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		return false;
+	}
+
+	// Hash while copying, the written copy is hashed again from disk below
+	QCryptographicHash sourceHash(QCryptographicHash::Sha256);
+	while (!source.atEnd()) {
+		const QByteArray chunk = source.read(COPY_CHUNK_SIZE);
+		if (chunk.isEmpty() && source.error() != QFileDevice::NoError) {
+			return false;
+		}
+		sourceHash.addData(chunk);
+		if (partial.write(chunk) != chunk.size()) {
+			return false;
+		}
+	}
+	if (!partial.flush()) {
+		return false;
+	}
+	partial.close();
+
+	QByteArray partialHash;
+	return hashFile(partialPath, partialHash) && partialHash == sourceHash.result();
+}
+
+// Unlike QFile::rename this replaces an existing destination in one step, MoveFileEx with replace on Windows
+bool replaceFile(const QString &fromPath, const QString &toPath)
+{
+	std::error_code error;
+	std::filesystem::rename(QFileInfo(fromPath).filesystemFilePath(), QFileInfo(toPath).filesystemFilePath(), error);
+	return !error;
+}
+
+} // namespace
+
+bool sameVolume(const QString &firstPath, const QString &secondPath)
+{
+	const QStorageInfo first(QFileInfo(firstPath).absolutePath());
+	const QStorageInfo second(QFileInfo(secondPath).absolutePath());
+	return first.isValid() && second.isValid() && first.device() == second.device();
+}
+
+bool move(const QString &sourcePath, const QString &destinationPath)
+{
+	// An existing destination is only replaced by the final rename, a failure leaves it as it was
+	if (sameVolume(sourcePath, destinationPath) && replaceFile(sourcePath, destinationPath)) {
+		return true;
+	}
+
+	// Different volume, copy under a temporary name so the real name never points at a partial file
+	const QString partialPath = destinationPath + PARTIAL_SUFFIX;
+	if (!copyVerified(sourcePath, partialPath) || !replaceFile(partialPath, destinationPath)) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to copy staged export file %s to %s",
+		     QT_TO_UTF8(sourcePath), QT_TO_UTF8(destinationPath));
+		QFile::remove(partialPath);
+		return false;
+	}
+
+	if (!QFile::remove(sourcePath)) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not remove staged export file: %s", QT_TO_UTF8(sourcePath));
+	}
+	return true;
+}
+
+} // namespace FileRelocate
@@ -0,0 +1,24 @@
+#pragma once
+
+#ifndef FILE_RELOCATE_HPP
+#define FILE_RELOCATE_HPP
+
+#include <QString>
+
+/**
+ * Moves finished export files from the staging directory to the recording's
+ * folder. On the same volume this is a single rename. Across volumes the file
+ * is copied to a temporary name next to the destination, read back and
+ * compared by hash, then renamed into place, so the destination name only
+ * ever refers to a complete file.
+ */
+namespace FileRelocate {
+
+bool sameVolume(const QString &firstPath, const QString &secondPath);
+
+// Replaces an existing destination file only once the new one is complete, the source is removed once the destination is verified
+bool move(const QString &sourcePath, const QString &destinationPath);
+
+} // namespace FileRelocate
+
+#endif // FILE_RELOCATE_HPP
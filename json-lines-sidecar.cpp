@@ -0,0 +1,211 @@
+#include "json-lines-sidecar.hpp"
+#include "chapter-export.hpp"
+#include <obs-module.h>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define QT_TO_UTF8(str) str.toUtf8().constData()
+
+namespace {
+
+// Only the file data has to reach the disk, the size update comes with it
+bool syncFileData(int fd)
+{
+#if defined(_WIN32)
+	return _commit(fd) == 0;
+#elif defined(__APPLE__)
+	return fsync(fd) == 0;
+#else
+	return fdatasync(fd) == 0;
+#endif
+}
+
+} // namespace
+
+JsonLinesSidecar::~JsonLinesSidecar()
+{
+	if (file.isOpen()) {
+		sync();
+		file.close();
+	}
+}
+
+bool JsonLinesSidecar::open(const QString &newFilePath, const QString &recordingName, const QString &sessionId,
+			    const Timecode::Timebase &newTimebase, Durability newDurability, int newSyncEvery)
+{
+	if (file.isOpen()) {
+		file.close();
+	}
+
+	filePath = newFilePath;
+	timebase = newTimebase;
+	durability = newDurability;
+	syncEvery = std::max(1, newSyncEvery);
+	sequence = 0;
+	unsyncedRecords = 0;
+	sessionIdJson = ChapterExport::escaped(sessionId, TextEscape::Mode::Json);
+
+	// Unbuffered so every record is one write and readers see whole lines
+	file.setFileName(filePath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+		return false;
+	}
+	sinceSync.start();
+
+	beginRecord("session");
+	appendString("recording", recordingName);
+	appendInt("fpsNum", timebase.fpsNum);
+	appendInt("fpsDen", timebase.fpsDen);
+	return endRecord();
+}
+
+void JsonLinesSidecar::close(uint64_t endFrame)
+{
+	if (!file.isOpen()) {
+		return;
+	}
+
+	beginRecord("end");
+	appendTime(endFrame);
+	endRecord();
+	if (durability != Durability::None) {
+		sync();
+	}
+	file.close();
+}
+
+bool JsonLinesSidecar::writeMarker(bool annotation, int markerId, uint64_t frameOffset, const QString &name, const QString &source)
+{
+	if (!file.isOpen()) {
+		return false;
+	}
+
+	beginRecord(annotation ? "annotation" : "chapter");
+	if (markerId >= 0) {
+		appendInt("markerId", markerId);
+	}
+	appendTime(frameOffset);
+	appendString("name", name);
+	appendString("source", source);
+	return endRecord();
+}
+
+bool JsonLinesSidecar::writeRename(int markerId, const QString &name)
+{
+	if (!file.isOpen()) {
+		return false;
+	}
+
+	beginRecord("rename");
+	appendInt("markerId", markerId);
+	appendString("name", name);
+	return endRecord();
+}
+
+bool JsonLinesSidecar::writeDelete(int markerId)
+{
+	if (!file.isOpen()) {
+		return false;
+	}
+
+	beginRecord("delete");
+	appendInt("markerId", markerId);
+	return endRecord();
+}
+
+void JsonLinesSidecar::syncIfDue()
+{
+	if (file.isOpen() && unsyncedRecords > 0 && sinceSync.elapsed() >= syncEvery) {
+		sync();
+	}
+}
+
+void JsonLinesSidecar::beginRecord(const char *type)
+{
+	line.clear();
+	line += "{\"seq\":";
+	line += QByteArray::number(static_cast<qulonglong>(sequence));
+	line += ",\"type\":\"";
+	line += type;
+	line += "\",\"sessionId\":\"";
+	line += sessionIdJson;
+	line += '"';
+}
+
+void JsonLinesSidecar::appendKey(const char *key)
+{
+	line += ",\"";
+	line += key;
+	line += "\":";
+}
+
+void JsonLinesSidecar::appendString(const char *key, const QString &value)
+{
+	appendKey(key);
+	line += '"';
+	ChapterExport::appendEscaped(line, value, TextEscape::Mode::Json);
+	line += '"';
+}
+
+void JsonLinesSidecar::appendInt(const char *key, int64_t value)
+{
+	appendKey(key);
+	line += QByteArray::number(static_cast<qlonglong>(value));
+}
+
+void JsonLinesSidecar::appendTime(uint64_t frameOffset)
+{
+	appendInt("frame", static_cast<int64_t>(frameOffset));
+	appendInt("timeMs", static_cast<int64_t>(Timecode::framesToMilliseconds(frameOffset, timebase)));
+
+	char timestamp[Timecode::BUFFER_SIZE];
+	appendKey("timestamp");
+	line += '"';
+	line.append(timestamp, static_cast<qsizetype>(Timecode::formatHmsMillis(timestamp, frameOffset, timebase)));
+	line += '"';
+}
+
+bool JsonLinesSidecar::endRecord()
+{
+	line += "}\n";
+	if (file.write(line) != line.size()) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Could not write to the JSON Lines file %s: %s", QT_TO_UTF8(filePath),
+		     QT_TO_UTF8(file.errorString()));
+		return false;
+	}
+	++sequence;
+	++unsyncedRecords;
+
+	switch (durability) {
+	case Durability::None:
+		break;
+	case Durability::EveryRecords:
+		if (unsyncedRecords >= syncEvery) {
+			return sync();
+		}
+		break;
+	case Durability::Interval:
+		// The timer covers quiet stretches, a busy stretch does not wait for it
+		if (sinceSync.elapsed() >= syncEvery) {
+			return sync();
+		}
+		break;
+	}
+	return true;
+}
+
+bool JsonLinesSidecar::sync()
+{
+	unsyncedRecords = 0;
+	sinceSync.restart();
+	if (!syncFileData(file.handle())) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not sync the JSON Lines file %s", QT_TO_UTF8(filePath));
+		return false;
+	}
+	return true;
+}
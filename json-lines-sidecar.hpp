@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef JSON_LINES_SIDECAR_HPP
+#define JSON_LINES_SIDECAR_HPP
+
+#include "timecode-format.hpp"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <cstdint>
+
+/**
+ * @class JsonLinesSidecar
+ * @brief Append-only JSON Lines export that other tools can follow while recording
+ *
+ * Every line is one complete JSON object with its own sequence number and
+ * the session id, so a reader tailing the file never has to look back:
+ *   {"seq":0,"type":"session","sessionId":"...","recording":"...","fpsNum":60,"fpsDen":1}
+ *   {"seq":1,"type":"chapter","sessionId":"...","markerId":0,"frame":0,"timeMs":0,"timestamp":"00:00:00.000","name":"Start","source":"Recording"}
+ *   {"seq":2,"type":"annotation",...}
+ *   {"seq":3,"type":"rename","sessionId":"...","markerId":0,"name":"Intro"}
+ *   {"seq":4,"type":"delete","sessionId":"...","markerId":0}
+ *   {"seq":5,"type":"end","sessionId":"...","frame":1234,"timeMs":20566,"timestamp":"00:00:20.566"}
+ * Renames and deletes are new records rather than edits, bytes already in
+ * the file never change.
+ *
+ * Lines are built in one reused buffer without a JSON document and handed to
+ * the OS with a single unbuffered write, so a reader never sees half a line
+ * unless the machine fails mid-write. How often the file is also forced to
+ * disk is the durability policy.
+ */
+class JsonLinesSidecar {
+public:
+	enum class Durability {
+		None, // The OS decides when data reaches the disk
+		EveryRecords, // fdatasync after every syncEvery records
+		Interval, // fdatasync at most every syncEvery milliseconds, driven by syncIfDue()
+	};
+
+	~JsonLinesSidecar();
+
+	bool open(const QString &filePath, const QString &recordingName, const QString &sessionId,
+		  const Timecode::Timebase &timebase, Durability durability, int syncEvery);
+	// Writes the end record and syncs, unless the policy is None
+	void close(uint64_t endFrame);
+	bool isOpen() const { return file.isOpen(); }
+	const QString &path() const { return filePath; }
+
+	// source is the locale-independent WebSocket name, not the UI label
+	bool writeMarker(bool annotation, int markerId, uint64_t frameOffset, const QString &name, const QString &source);
+	bool writeRename(int markerId, const QString &name);
+	bool writeDelete(int markerId);
+
+	// Called from a timer for the Interval policy, a sync only happens when records were written
+	void syncIfDue();
+
+private:
+	void beginRecord(const char *type);
+	void appendKey(const char *key);
+	void appendString(const char *key, const QString &value);
+	void appendInt(const char *key, int64_t value);
+	void appendTime(uint64_t frameOffset);
+	bool endRecord();
+	bool sync();
+
+	QFile file;
+	QString filePath;
+	QByteArray sessionIdJson; // Already escaped
+	Timecode::Timebase timebase;
+	Durability durability = Durability::None;
+	int syncEvery = 1;
+
+	QByteArray line; // Reused for every record
+	uint64_t sequence = 0;
+	int unsyncedRecords = 0;
+	QElapsedTimer sinceSync;
+};
+
+#endif // JSON_LINES_SIDECAR_HPP
@@ -0,0 +1,46 @@
+#include "marker-source.hpp"
+#include <obs-module.h>
+
+namespace MarkerSource {
+
+namespace {
+
+QString labels[KIND_COUNT];
+
+} // namespace
+
+void loadLabels()
+{
+	for (size_t i = 0; i < KIND_COUNT; ++i) {
+		labels[i] = INFO[i].localeKey ? QString::fromUtf8(obs_module_text(INFO[i].localeKey)) : QString();
+	}
+}
+
+const QString &label(Kind kind)
+{
+	return labels[static_cast<size_t>(kind)];
+}
+
+QString Source::webSocketName() const
+{
+	return kind == Kind::Custom ? customLabel : QString::fromLatin1(info().webSocketName);
+}
+
+Source Source::fromWebSocketName(const QString &name)
+{
+	if (name.isEmpty()) {
+		return Source(Kind::WebSocket);
+	}
+
+	for (size_t i = 0; i < KIND_COUNT; ++i) {
+		if (INFO[i].webSocketName && name.compare(QLatin1String(INFO[i].webSocketName), Qt::CaseInsensitive) == 0) {
+			return Source(static_cast<Kind>(i));
+		}
+	}
+
+	Source custom(Kind::Custom);
+	custom.customLabel = name;
+	return custom;
+}
+
+} // namespace MarkerSource
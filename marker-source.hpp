@@ -0,0 +1,85 @@
+#pragma once
+
+#ifndef MARKER_SOURCE_HPP
+#define MARKER_SOURCE_HPP
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @namespace MarkerSource
+ * @brief What triggered a marker or annotation, independent of the UI language
+ *
+ * Exporters branch on Kind and read colors and names from the constexpr table.
+ * Localized labels are looked up once by loadLabels() when the module loads.
+ */
+namespace MarkerSource {
+
+enum class Kind : uint8_t {
+	Manual,
+	Hotkey,
+	PresetHotkey,
+	SceneChange,
+	Recording,
+	WebSocket,
+	Custom, // Free text sent by a WebSocket client
+	Script, // Native proc call from a script or another plugin
+	Osc, // OSC message from a control surface
+	Silence, // Speech resumed after a long silence
+	Count
+};
+
+struct Info {
+	const char *localeKey;
+	const char *edlColor; // DaVinci Resolve marker color
+	int lane; // Default marker lane, manual markers on top
+	const char *webSocketName; // Stable name used on the WebSocket API
+};
+
+constexpr size_t KIND_COUNT = static_cast<size_t>(Kind::Count);
+
+// Order matches Kind, kinds are stored in the chapter index so new ones go at the end
+constexpr Info INFO[KIND_COUNT] = {
+	{"SourceManual", "ResolveColorGreen", 0, "Manual"},
+	{"Hotkey", "ResolveColorPurple", 1, "Hotkey"},
+	{"PresetHotkey", "ResolveColorPurple", 1, "PresetHotkey"},
+	{"ChangeScene", "ResolveColorYellow", 2, "SceneChange"},
+	{"Recording", "ResolveColorBlue", 3, "Recording"},
+	{"WebSocket", "ResolveColorBlue", 4, "WebSocket"},
+	{nullptr, "ResolveColorBlue", 4, nullptr},
+	{"SourceScript", "ResolveColorCyan", 4, "Script"},
+	{"SourceOsc", "ResolveColorPink", 4, "OSC"},
+	{"SourceSilence", "ResolveColorMint", 2, "Silence"},
+};
+
+constexpr const Info &info(Kind kind)
+{
+	return INFO[static_cast<size_t>(kind)];
+}
+
+void loadLabels();
+const QString &label(Kind kind);
+
+/**
+ * @struct Source
+ * @brief Kind of a marker plus the client text for Custom sources
+ */
+struct Source {
+	Kind kind = Kind::Manual;
+	QString customLabel;
+
+	Source() = default;
+	Source(Kind sourceKind) : kind(sourceKind) {}
+
+	const Info &info() const { return MarkerSource::info(kind); }
+	const QString &label() const { return kind == Kind::Custom ? customLabel : MarkerSource::label(kind); }
+	QString webSocketName() const;
+
+	// Known names map back to their kind, anything else is kept as Custom, empty means WebSocket
+	static Source fromWebSocketName(const QString &name);
+};
+
+} // namespace MarkerSource
+
+#endif // MARKER_SOURCE_HPP
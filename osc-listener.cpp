@@ -0,0 +1,106 @@
+#include "osc-listener.hpp"
+#include "osc-message.hpp"
+#include <obs-module.h>
+#include <obs.h>
+#include <QUdpSocket>
+
+namespace {
+
+QString argumentText(const Osc::Message &message)
+{
+	if (message.argumentCount == 0) {
+		return QString();
+	}
+
+	const Osc::Argument &argument = message.arguments[0];
+	if (argument.type == 's' || argument.type == 'S') {
+		return QString::fromUtf8(argument.stringValue.data(), static_cast<qsizetype>(argument.stringValue.size()));
+	}
+	int number;
+	return argument.toInt(number) ? QString::number(number) : QString();
+}
+
+} // namespace
+
+OscListener::OscListener(QObject *parent) : QThread(parent) {}
+
+OscListener::~OscListener()
+{
+	stopListening();
+}
+
+void OscListener::startListening(quint16 newPort, bool newAllInterfaces)
+{
+	if (isRunning() && newPort == port && newAllInterfaces == allInterfaces) {
+		return;
+	}
+	stopListening();
+	port = newPort;
+	allInterfaces = newAllInterfaces;
+	start();
+}
+
+void OscListener::stopListening()
+{
+	if (isRunning()) {
+		quit();
+		wait();
+	}
+}
+
+void OscListener::run()
+{
+	QUdpSocket socket;
+	// Any device on the network could add markers, so other interfaces are opt-in
+	const QHostAddress address = allInterfaces ? QHostAddress(QHostAddress::Any) : QHostAddress(QHostAddress::LocalHost);
+	if (!socket.bind(address, port)) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not listen for OSC on UDP port %u: %s",
+		     static_cast<unsigned>(port), socket.errorString().toUtf8().constData());
+		return;
+	}
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Listening for OSC on UDP port %u (%s)", static_cast<unsigned>(port),
+	     allInterfaces ? "all interfaces" : "this computer only");
+
+	connect(&socket, &QUdpSocket::readyRead, &socket, [this, &socket]() {
+		while (socket.hasPendingDatagrams()) {
+			// Sampled before anything else so parsing does not move the marker
+			const uint64_t totalFrames = obs_get_total_frames();
+
+			const qint64 size = socket.pendingDatagramSize();
+			if (size > datagram.size()) {
+				datagram.resize(size);
+			}
+			const qint64 received = socket.readDatagram(datagram.data(), datagram.size());
+			if (received <= 0) {
+				continue;
+			}
+
+			const bool wellFormed =
+				Osc::forEachMessage(datagram.constData(), static_cast<size_t>(received),
+						    [this, totalFrames](const Osc::Message &message) { handleMessage(message, totalFrames); });
+			if (!wellFormed) {
+				blog(LOG_DEBUG, "[StreamUP Record Chapter Manager] Ignored malformed OSC packet of %lld bytes",
+				     static_cast<long long>(received));
+			}
+		}
+	});
+
+	exec();
+}
+
+void OscListener::handleMessage(const Osc::Message &message, uint64_t totalFrames)
+{
+	if (message.address == "/chapter") {
+		emit chapterReceived(argumentText(message), totalFrames);
+	} else if (message.address == "/annotation") {
+		const QString annotationText = argumentText(message);
+		if (!annotationText.isEmpty()) {
+			emit annotationReceived(annotationText, totalFrames);
+		}
+	} else if (message.address == "/chapter/preset") {
+		int presetNumber;
+		if (message.argumentCount > 0 && message.arguments[0].toInt(presetNumber)) {
+			emit presetChapterReceived(presetNumber, totalFrames);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef OSC_LISTENER_HPP
+#define OSC_LISTENER_HPP
+
+#include <QByteArray>
+#include <QString>
+#include <QThread>
+#include <cstdint>
+
+namespace Osc {
+struct Message;
+}
+
+/**
+ * @class OscListener
+ * @brief UDP thread that turns OSC messages from control surfaces into markers
+ *
+ * Understood addresses:
+ *   /chapter [name]          chapter marker, the default name when empty
+ *   /annotation <text>       annotation
+ *   /chapter/preset <number> preset chapter, numbered from 1 as in the settings
+ *
+ * The OBS frame count is sampled as soon as a datagram arrives, before it is
+ * parsed, and travels with the signal so the marker lands where the cue was
+ * fired even if the UI thread is busy. Datagrams are read into one reused
+ * buffer and parsed in place. Only this computer can send cues unless all
+ * interfaces are enabled.
+ */
+class OscListener : public QThread {
+	Q_OBJECT
+
+public:
+	explicit OscListener(QObject *parent = nullptr);
+	~OscListener() override;
+
+	// Restarts the thread when the port or the interfaces change
+	void startListening(quint16 port, bool allInterfaces);
+	void stopListening();
+	quint16 listeningPort() const { return port; }
+
+signals:
+	void chapterReceived(const QString &chapterName, quint64 totalFrames);
+	void annotationReceived(const QString &annotationText, quint64 totalFrames);
+	void presetChapterReceived(int presetNumber, quint64 totalFrames);
+
+protected:
+	void run() override;
+
+private:
+	void handleMessage(const Osc::Message &message, uint64_t totalFrames);
+
+	quint16 port = 0;
+	bool allInterfaces = false;
+	QByteArray datagram;
+};
+
+#endif // OSC_LISTENER_HPP
@@ -0,0 +1,183 @@
+#include "osc-message.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace Osc {
+
+namespace {
+
+uint32_t readUint32(const char *data)
+{
+	const auto *bytes = reinterpret_cast<const unsigned char *>(data);
+	return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+	       (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+uint64_t readUint64(const char *data)
+{
+	return (static_cast<uint64_t>(readUint32(data)) << 32) | readUint32(data + 4);
+}
+
+// Strings are NUL terminated and padded to a multiple of 4 bytes
+bool readString(const char *data, size_t size, size_t &offset, std::string_view &out)
+{
+	if (offset >= size) {
+		return false;
+	}
+	const void *end = memchr(data + offset, '\0', size - offset);
+	if (!end) {
+		return false;
+	}
+	const size_t length = static_cast<size_t>(static_cast<const char *>(end) - (data + offset));
+	out = std::string_view(data + offset, length);
+	offset += (length + 4) & ~static_cast<size_t>(3);
+	return offset <= size;
+}
+
+} // namespace
+
+bool Argument::toInt(int &out) const
+{
+	switch (type) {
+	case 'i':
+	case 'h':
+		// 64-bit arguments saturate rather than wrap
+		out = static_cast<int>(std::clamp<int64_t>(intValue, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+		return true;
+	case 'f':
+	case 'd': {
+		// Converting NaN, infinity or an out of range value to int is undefined
+		if (!std::isfinite(floatValue)) {
+			return false;
+		}
+		const double rounded = std::round(floatValue);
+		out = static_cast<int>(std::clamp(rounded, static_cast<double>(std::numeric_limits<int>::min()),
+						   static_cast<double>(std::numeric_limits<int>::max())));
+		return true;
+	}
+	case 's':
+	case 'S': {
+		const char *first = stringValue.data();
+		const char *last = first + stringValue.size();
+		return std::from_chars(first, last, out).ptr == last && first != last;
+	}
+	default:
+		return false;
+	}
+}
+
+bool isBundle(const char *data, size_t size)
+{
+	return size >= 16 && memcmp(data, "#bundle", 8) == 0;
+}
+
+bool parseMessage(const char *data, size_t size, Message &out)
+{
+	out.argumentCount = 0;
+	if (size < 4 || size % 4 != 0 || data[0] != '/') {
+		return false;
+	}
+
+	size_t offset = 0;
+	if (!readString(data, size, offset, out.address)) {
+		return false;
+	}
+
+	// Very old senders leave out the type tags, such a message has no arguments
+	std::string_view typeTags;
+	if (offset == size) {
+		return true;
+	}
+	if (data[offset] != ',' || !readString(data, size, offset, typeTags)) {
+		return false;
+	}
+
+	for (size_t i = 1; i < typeTags.size(); ++i) {
+		Argument argument;
+		argument.type = typeTags[i];
+		switch (argument.type) {
+		case 'i':
+			if (size - offset < 4) {
+				return false;
+			}
+			argument.intValue = static_cast<int32_t>(readUint32(data + offset));
+			offset += 4;
+			break;
+		case 'f': {
+			if (size - offset < 4) {
+				return false;
+			}
+			const uint32_t bits = readUint32(data + offset);
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			argument.floatValue = value;
+			offset += 4;
+			break;
+		}
+		case 'h':
+		case 't':
+			if (size - offset < 8) {
+				return false;
+			}
+			argument.intValue = static_cast<int64_t>(readUint64(data + offset));
+			offset += 8;
+			break;
+		case 'd': {
+			if (size - offset < 8) {
+				return false;
+			}
+			const uint64_t bits = readUint64(data + offset);
+			memcpy(&argument.floatValue, &bits, sizeof(argument.floatValue));
+			offset += 8;
+			break;
+		}
+		case 's':
+		case 'S':
+			if (!readString(data, size, offset, argument.stringValue)) {
+				return false;
+			}
+			break;
+		case 'b': {
+			// Blobs are skipped, nothing here takes binary data
+			if (size - offset < 4) {
+				return false;
+			}
+			const size_t blobSize = readUint32(data + offset);
+			const size_t paddedSize = (blobSize + 3) & ~static_cast<size_t>(3);
+			if (paddedSize > size - offset - 4) {
+				return false;
+			}
+			offset += 4 + paddedSize;
+			break;
+		}
+		case 'c':
+		case 'r':
+		case 'm':
+			if (size - offset < 4) {
+				return false;
+			}
+			offset += 4;
+			break;
+		case 'T':
+		case 'F':
+			argument.intValue = argument.type == 'T' ? 1 : 0;
+			break;
+		case 'N':
+		case 'I':
+		case '[':
+		case ']':
+			break;
+		default:
+			return false;
+		}
+
+		if (out.argumentCount < Message::MAX_ARGUMENTS) {
+			out.arguments[out.argumentCount++] = argument;
+		}
+	}
+	return true;
+}
+
+} // namespace Osc
@@ -0,0 +1,83 @@
+#pragma once
+
+#ifndef OSC_MESSAGE_HPP
+#define OSC_MESSAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * @namespace Osc
+ * @brief Open Sound Control 1.0 packet parser that does not copy
+ *
+ * The address and string arguments of a parsed message point into the
+ * received datagram, so the buffer must outlive the message. Bundles are
+ * walked element by element, nested ones included, and their timetags are
+ * ignored because markers are placed at the time the packet arrived.
+ * Argument types without a fixed size that OSC 1.0 does not define make the
+ * packet malformed, there is no way to skip them.
+ */
+namespace Osc {
+
+constexpr int MAX_BUNDLE_DEPTH = 4;
+
+struct Argument {
+	char type = 0; // OSC type tag, 'i', 'f', 's' and so on
+	int64_t intValue = 0; // 'i', 'h', 'T' and 'F'
+	double floatValue = 0.0; // 'f' and 'd'
+	std::string_view stringValue; // 's' and 'S'
+
+	// Numbers and numeric strings, controllers differ in what they send for an index
+	bool toInt(int &out) const;
+};
+
+struct Message {
+	static constexpr int MAX_ARGUMENTS = 8; // Further arguments are checked but not kept
+
+	std::string_view address;
+	Argument arguments[MAX_ARGUMENTS];
+	int argumentCount = 0;
+};
+
+bool isBundle(const char *data, size_t size);
+bool parseMessage(const char *data, size_t size, Message &out);
+
+// Calls onMessage for each message in the packet, returns false if any part is malformed
+template<typename Callback> bool forEachMessage(const char *data, size_t size, Callback &&onMessage, int depth = 0)
+{
+	if (!isBundle(data, size)) {
+		Message message;
+		if (!parseMessage(data, size, message)) {
+			return false;
+		}
+		onMessage(message);
+		return true;
+	}
+
+	if (depth >= MAX_BUNDLE_DEPTH) {
+		return false;
+	}
+
+	// "#bundle\0", an 8 byte timetag, then elements each led by a big-endian size
+	size_t offset = 16;
+	while (offset + 4 <= size) {
+		const auto *sizeBytes = reinterpret_cast<const unsigned char *>(data + offset);
+		const size_t elementSize = (static_cast<size_t>(sizeBytes[0]) << 24) | (static_cast<size_t>(sizeBytes[1]) << 16) |
+					   (static_cast<size_t>(sizeBytes[2]) << 8) | static_cast<size_t>(sizeBytes[3]);
+		offset += 4;
+		if (elementSize == 0 || elementSize % 4 != 0 || elementSize > size - offset) {
+			return false;
+		}
+		if (!forEachMessage(data + offset, elementSize, onMessage, depth + 1)) {
+			return false;
+		}
+		offset += elementSize;
+	}
+	return offset == size;
+}
+
+} // namespace Osc
+
+#endif // OSC_MESSAGE_HPP
@@ -0,0 +1,380 @@
+#include "session-catalog.hpp"
+#include "annotation-store.hpp"
+#include "chapter-index.hpp"
+#include "constants.hpp"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+constexpr const char *TEXT_HEADER_PREFIX = "Chapter Markers for ";
+constexpr const char *TEXT_ANNOTATION_PREFIX = "(Annotation) ";
+
+QJsonObject toJson(const SessionCatalog::Session &session)
+{
+	QJsonArray entries;
+	for (const SessionCatalog::Entry &entry : session.entries) {
+		QJsonObject object{{"frame", static_cast<qint64>(entry.frameOffset)}, {"text", entry.text}};
+		if (!entry.source.isEmpty()) {
+			object.insert("source", entry.source);
+		}
+		if (entry.annotation) {
+			object.insert("annotation", true);
+		}
+		entries.append(object);
+	}
+
+	return QJsonObject{{"recording", session.recordingPath},
+			   {"fpsNum", static_cast<qint64>(session.timebase.fpsNum)},
+			   {"fpsDen", static_cast<qint64>(session.timebase.fpsDen)},
+			   {"recordedAt", session.recordedAtMs},
+			   {"entries", entries}};
+}
+
+SessionCatalog::Session fromJson(const QJsonObject &object)
+{
+	SessionCatalog::Session session;
+	session.recordingPath = object.value("recording").toString();
+	session.timebase.fpsNum = static_cast<uint32_t>(object.value("fpsNum").toInteger(session.timebase.fpsNum));
+	session.timebase.fpsDen = static_cast<uint32_t>(object.value("fpsDen").toInteger(session.timebase.fpsDen));
+	session.recordedAtMs = object.value("recordedAt").toInteger();
+
+	const QJsonArray entries = object.value("entries").toArray();
+	session.entries.reserve(entries.size());
+	for (const QJsonValue &value : entries) {
+		const QJsonObject entry = value.toObject();
+		session.entries.append({static_cast<uint64_t>(entry.value("frame").toInteger()), entry.value("annotation").toBool(),
+					entry.value("text").toString(), entry.value("source").toString()});
+	}
+	return session;
+}
+
+// The recording next to its sidecars, found by its base name with any extension
+QString findRecording(const QString &directoryPath, const QString &baseName)
+{
+	const QFileInfoList candidates = QDir(directoryPath).entryInfoList({baseName + ".*"}, QDir::Files);
+	for (const QFileInfo &candidate : candidates) {
+		if (candidate.completeBaseName() == baseName) {
+			return candidate.absoluteFilePath();
+		}
+	}
+	return directoryPath + "/" + baseName;
+}
+
+qint64 fileTimeMs(const QFileInfo &info)
+{
+	const QDateTime created = info.birthTime();
+	return (created.isValid() ? created : info.lastModified()).toMSecsSinceEpoch();
+}
+
+} // namespace
+
+//--------------------CATALOG--------------------
+bool SessionCatalog::open(const QString &catalogFilePath)
+{
+	QWriteLocker locker(&lock);
+	path = catalogFilePath;
+	sessions.clear();
+	replaced.clear();
+	sessionByPath.clear();
+	postings.clear();
+	sortedTerms.clear();
+
+	QFile file(path);
+	if (!file.exists()) {
+		return true;
+	}
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+
+	while (!file.atEnd()) {
+		const QByteArray line = file.readLine().trimmed();
+		// A line cut short when OBS crashed mid-write is skipped
+		const QJsonDocument document = QJsonDocument::fromJson(line);
+		if (document.isObject()) {
+			indexSession(fromJson(document.object()), false);
+		}
+	}
+
+	// Terms are sorted once after loading instead of on every insert
+	std::sort(sortedTerms.begin(), sortedTerms.end());
+	return true;
+}
+
+bool SessionCatalog::add(const Session &session)
+{
+	const QByteArray line = QJsonDocument(toJson(session)).toJson(QJsonDocument::Compact) + '\n';
+
+	QWriteLocker locker(&lock);
+	if (path.isEmpty() || !QDir().mkpath(QFileInfo(path).absolutePath())) {
+		return false;
+	}
+
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(line) != line.size()) {
+		return false;
+	}
+	indexSession(session, true);
+	return true;
+}
+
+bool SessionCatalog::contains(const QString &recordingPath) const
+{
+	QReadLocker locker(&lock);
+	return sessionByPath.contains(recordingPath);
+}
+
+int SessionCatalog::sessionCount() const
+{
+	QReadLocker locker(&lock);
+	return static_cast<int>(sessionByPath.size());
+}
+
+void SessionCatalog::indexSession(const Session &session, bool keepTermsSorted)
+{
+	const int sessionIndex = static_cast<int>(sessions.size());
+	const auto previous = sessionByPath.constFind(session.recordingPath);
+	if (previous != sessionByPath.constEnd()) {
+		replaced[*previous] = true;
+	}
+	sessionByPath.insert(session.recordingPath, sessionIndex);
+	sessions.append(session);
+	replaced.append(false);
+
+	// Sessions and entries are indexed in order, so every posting list stays sorted
+	QStringList tokens;
+	for (int i = 0; i < session.entries.size(); ++i) {
+		tokens.clear();
+		tokenize(session.entries[i].text, tokens);
+		tokens.removeDuplicates();
+		for (const QString &token : tokens) {
+			auto found = postings.find(token);
+			if (found == postings.end()) {
+				found = postings.insert(token, QVector<Posting>());
+				if (keepTermsSorted) {
+					sortedTerms.insert(std::lower_bound(sortedTerms.begin(), sortedTerms.end(), token), token);
+				} else {
+					sortedTerms.append(token);
+				}
+			}
+			found->append({sessionIndex, i});
+		}
+	}
+}
+
+//--------------------SEARCH--------------------
+void SessionCatalog::tokenize(const QString &text, QStringList &tokens)
+{
+	// Words are runs of letters and digits, compared case-folded
+	const QString folded = text.toCaseFolded();
+	qsizetype start = -1;
+	for (qsizetype i = 0; i <= folded.size(); ++i) {
+		const bool wordChar = i < folded.size() && folded.at(i).isLetterOrNumber();
+		if (wordChar && start < 0) {
+			start = i;
+		} else if (!wordChar && start >= 0) {
+			tokens.append(folded.mid(start, i - start));
+			start = -1;
+		}
+	}
+}
+
+QVector<SessionCatalog::Posting> SessionCatalog::prefixPostings(const QString &prefix) const
+{
+	QVector<Posting> result;
+	int termCount = 0;
+	for (auto term = std::lower_bound(sortedTerms.cbegin(), sortedTerms.cend(), prefix);
+	     term != sortedTerms.cend() && term->startsWith(prefix); ++term) {
+		result += postings.value(*term);
+		termCount++;
+	}
+
+	// Lists of several terms overlap where an entry holds more than one of them
+	if (termCount > 1) {
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
+	return result;
+}
+
+QVector<SessionCatalog::Match> SessionCatalog::search(const QString &query, int limit) const
+{
+	QVector<Match> matches;
+	QStringList tokens;
+	tokenize(query, tokens);
+	tokens.removeDuplicates();
+	if (tokens.isEmpty() || limit <= 0) {
+		return matches;
+	}
+
+	QReadLocker locker(&lock);
+	QVector<Posting> result = prefixPostings(tokens.constLast());
+	for (qsizetype i = 0; i + 1 < tokens.size() && !result.isEmpty(); ++i) {
+		const auto found = postings.constFind(tokens.at(i));
+		if (found == postings.constEnd()) {
+			return matches;
+		}
+		QVector<Posting> intersection;
+		std::set_intersection(result.cbegin(), result.cend(), found->cbegin(), found->cend(),
+				      std::back_inserter(intersection));
+		result.swap(intersection);
+	}
+
+	// Most recently catalogued sessions first
+	for (auto posting = result.crbegin(); posting != result.crend() && matches.size() < limit; ++posting) {
+		if (replaced.at(posting->session)) {
+			continue;
+		}
+		const Session &session = sessions.at(posting->session);
+		matches.append({session.recordingPath, session.timebase, session.recordedAtMs, session.entries.at(posting->entry)});
+	}
+	return matches;
+}
+
+//--------------------BACKFILL--------------------
+QHash<QString, QString> SessionCatalog::readAnnotationBodies(const QString &storeFilePath)
+{
+	// Records are "@<id> <byte length>" followed by the body and a newline
+	QHash<QString, QString> bodies;
+	QFile file(storeFilePath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return bodies;
+	}
+
+	const QByteArray data = file.readAll();
+	qsizetype position = 0;
+	while (position < data.size()) {
+		const qsizetype lineEnd = data.indexOf('\n', position);
+		if (lineEnd < 0) {
+			break;
+		}
+		const QByteArray line = data.mid(position, lineEnd - position);
+		position = lineEnd + 1;
+		if (!line.startsWith('@')) {
+			continue;
+		}
+
+		const qsizetype space = line.indexOf(' ');
+		bool ok = false;
+		const qsizetype length = space < 0 ? -1 : static_cast<qsizetype>(line.mid(space + 1).toLongLong(&ok));
+		if (!ok || length < 0 || position + length > data.size()) {
+			break;
+		}
+		bodies.insert(QString::fromLatin1(line.mid(1, space - 1)), QString::fromUtf8(data.mid(position, length)));
+		position += length + 1;
+	}
+	return bodies;
+}
+
+bool SessionCatalog::readChapterIndex(const QString &indexFilePath, Session &out)
+{
+	ChapterIndexReader reader;
+	if (!reader.open(indexFilePath)) {
+		return false;
+	}
+
+	const QFileInfo info(indexFilePath);
+	QString baseName = info.fileName();
+	if (baseName.endsWith(Constants::CHAPTER_INDEX_FILE_SUFFIX)) {
+		baseName.chop(static_cast<qsizetype>(strlen(Constants::CHAPTER_INDEX_FILE_SUFFIX)));
+	}
+	out.recordingPath = findRecording(info.absolutePath(), baseName);
+	out.timebase = reader.timebase();
+	out.recordedAtMs = reader.anchor().wallClockNs != 0 ? reader.anchor().wallClockNs / 1000000 : fileTimeMs(info);
+
+	// The index only holds annotation titles, the store next to it has the full text
+	QHash<QString, QString> bodyByTitle;
+	const QHash<QString, QString> bodies =
+		readAnnotationBodies(info.absolutePath() + "/" + baseName + Constants::ANNOTATION_STORE_FILE_SUFFIX);
+	for (const QString &body : bodies) {
+		bodyByTitle.insert(AnnotationStore::makeTitle(body, Constants::ANNOTATION_TITLE_LENGTH), body);
+	}
+
+	out.entries.clear();
+	out.entries.reserve(static_cast<qsizetype>(reader.recordCount()));
+	for (uint32_t i = 0; i < reader.recordCount(); ++i) {
+		const ChapterIndex::Record record = reader.record(i);
+		if (record.flags & ChapterIndex::RecordDeleted) {
+			continue;
+		}
+		const bool annotation = (record.flags & ChapterIndex::RecordAnnotation) != 0;
+		const QString name = reader.string(record.nameOffset, record.nameLength);
+		out.entries.append({record.frameOffset, annotation, annotation ? bodyByTitle.value(name, name) : name,
+				    reader.string(record.sourceOffset, record.sourceLength)});
+	}
+	return true;
+}
+
+bool SessionCatalog::readChapterText(const QString &textFilePath, Session &out)
+{
+	QFile file(textFilePath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+
+	const QFileInfo info(textFilePath);
+	QString baseName = info.fileName();
+	if (baseName.endsWith(Constants::TEXT_FILE_SUFFIX)) {
+		baseName.chop(static_cast<qsizetype>(strlen(Constants::TEXT_FILE_SUFFIX)));
+	}
+	out.recordingPath = findRecording(info.absolutePath(), baseName);
+	// The text file only has whole seconds, one frame per second keeps them exact
+	out.timebase = {1, 1};
+	out.recordedAtMs = fileTimeMs(info);
+	out.entries.clear();
+
+	const QHash<QString, QString> bodies =
+		readAnnotationBodies(info.absolutePath() + "/" + baseName + Constants::ANNOTATION_STORE_FILE_SUFFIX);
+
+	// Lines are "HH:MM:SS - name", annotations "HH:MM:SS - (Annotation) title [#id] (source)"
+	while (!file.atEnd()) {
+		const QString line = QString::fromUtf8(file.readLine()).trimmed();
+		if (line.startsWith(TEXT_HEADER_PREFIX)) {
+			continue;
+		}
+		const qsizetype separator = line.indexOf(" - ");
+		const QStringList time = line.left(separator).split(':');
+		if (separator < 0 || time.size() != 3) {
+			continue;
+		}
+
+		bool hoursOk = false;
+		bool minutesOk = false;
+		bool secondsOk = false;
+		const uint64_t seconds = time.at(0).toULongLong(&hoursOk) * 3600 + time.at(1).toULongLong(&minutesOk) * 60 +
+					 time.at(2).toULongLong(&secondsOk);
+		if (!hoursOk || !minutesOk || !secondsOk) {
+			continue;
+		}
+
+		Entry entry;
+		entry.frameOffset = seconds;
+		entry.text = line.mid(separator + 3);
+		if (entry.text.startsWith(TEXT_ANNOTATION_PREFIX)) {
+			entry.annotation = true;
+			entry.text.remove(0, static_cast<qsizetype>(strlen(TEXT_ANNOTATION_PREFIX)));
+
+			const qsizetype sourceStart = entry.text.lastIndexOf(" (");
+			if (sourceStart >= 0 && entry.text.endsWith(')')) {
+				entry.source = entry.text.mid(sourceStart + 2, entry.text.size() - sourceStart - 3);
+				entry.text.truncate(sourceStart);
+			}
+			const qsizetype referenceStart = entry.text.lastIndexOf(" [#");
+			if (referenceStart >= 0 && entry.text.endsWith(']')) {
+				const QString id = entry.text.mid(referenceStart + 3, entry.text.size() - referenceStart - 4);
+				entry.text = bodies.value(id, entry.text.left(referenceStart));
+			}
+		}
+		out.entries.append(entry);
+	}
+	return true;
+}
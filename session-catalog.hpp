@@ -0,0 +1,90 @@
+#pragma once
+
+#ifndef SESSION_CATALOG_HPP
+#define SESSION_CATALOG_HPP
+
+#include "timecode-format.hpp"
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <cstdint>
+
+/**
+ * @class SessionCatalog
+ * @brief Local catalog of finished recordings with a full-text index on their chapters
+ *
+ * Sessions are appended to a JSON Lines file, one recording per line, and the
+ * whole file is indexed in memory when the catalog opens. Each word of a
+ * chapter or annotation maps to the entries that contain it, so a search
+ * intersects a few posting lists instead of scanning every session. The last
+ * query word also matches as a prefix, which keeps search-as-you-type useful.
+ * Results list the most recently catalogued sessions first.
+ *
+ * Recording a path again replaces the earlier session, so backfilling a
+ * folder twice is harmless. All members may be called from any thread.
+ */
+class SessionCatalog {
+public:
+	static constexpr int DEFAULT_RESULT_LIMIT = 50;
+
+	struct Entry {
+		uint64_t frameOffset = 0;
+		bool annotation = false;
+		QString text;
+		QString source;
+	};
+
+	struct Session {
+		QString recordingPath;
+		Timecode::Timebase timebase;
+		qint64 recordedAtMs = 0; // Milliseconds since the Unix epoch
+		QVector<Entry> entries;
+	};
+
+	struct Match {
+		QString recordingPath;
+		Timecode::Timebase timebase;
+		qint64 recordedAtMs;
+		Entry entry;
+	};
+
+	// Loads and indexes the catalog file, it is created with the first session
+	bool open(const QString &catalogFilePath);
+	bool add(const Session &session);
+	bool contains(const QString &recordingPath) const;
+	int sessionCount() const;
+	// Every word must appear in the entry
+	QVector<Match> search(const QString &query, int limit = DEFAULT_RESULT_LIMIT) const;
+
+	// Backfill from the sidecars of older recordings, the binary index is preferred over the text file
+	static bool readChapterIndex(const QString &indexFilePath, Session &out);
+	static bool readChapterText(const QString &textFilePath, Session &out);
+
+private:
+	struct Posting {
+		int session;
+		int entry;
+		bool operator<(const Posting &other) const
+		{
+			return session < other.session || (session == other.session && entry < other.entry);
+		}
+		bool operator==(const Posting &other) const { return session == other.session && entry == other.entry; }
+	};
+
+	static void tokenize(const QString &text, QStringList &tokens);
+	static QHash<QString, QString> readAnnotationBodies(const QString &storeFilePath);
+	void indexSession(const Session &session, bool keepTermsSorted);
+	QVector<Posting> prefixPostings(const QString &prefix) const;
+
+	mutable QReadWriteLock lock;
+	QString path;
+	QVector<Session> sessions;
+	QVector<bool> replaced; // Set when a later session took over the recording path
+	QHash<QString, int> sessionByPath;
+	QHash<QString, QVector<Posting>> postings;
+	QStringList sortedTerms; // Kept sorted for prefix lookups
+};
+
+#endif // SESSION_CATALOG_HPP
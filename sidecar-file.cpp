@@ -0,0 +1,129 @@
+#include "sidecar-file.hpp"
+#include <obs-module.h>
+#include <QFile>
+
+#define QT_TO_UTF8(str) str.toUtf8().constData()
+
+void SidecarFile::reset(const QString &newFilePath)
+{
+	filePath = newFilePath;
+	ranges.clear();
+	trailer.clear();
+}
+
+bool SidecarFile::create(const QByteArray &header)
+{
+	ranges.clear();
+	trailer.clear();
+
+	QFile file(filePath);
+	if (filePath.isEmpty() || !file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		return false;
+	}
+	file.close();
+	return append(header);
+}
+
+QByteArray SidecarFile::toDiskBytes(const QByteArray &data)
+{
+#ifdef _WIN32
+	// Same bytes QIODevice::Text produces, the headers are still written through it
+	QByteArray converted = data;
+	converted.replace("\n", "\r\n");
+	return converted;
+#else
+	return data;
+#endif
+}
+
+bool SidecarFile::append(const QByteArray &data, int markerId, int tag)
+{
+	if (filePath.isEmpty()) {
+		return false;
+	}
+
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadWrite)) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open export file: %s", QT_TO_UTF8(filePath));
+		return false;
+	}
+
+	// The new data overwrites the trailer and the trailer is written again behind it in the same write
+	const QByteArray bytes = toDiskBytes(data);
+	const qint64 offset = qMax<qint64>(0, file.size() - trailer.size());
+	const QByteArray block = bytes + trailer;
+	if (!file.seek(offset) || file.write(block) != block.size()) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to write export file: %s", QT_TO_UTF8(filePath));
+		return false;
+	}
+
+	if (markerId >= 0) {
+		ranges.append({markerId, tag, offset, bytes.size()});
+	}
+	return true;
+}
+
+bool SidecarFile::setTrailer(const QByteArray &data)
+{
+	if (!trailer.isEmpty() || !append(data)) {
+		return false;
+	}
+	trailer = toDiskBytes(data);
+	return true;
+}
+
+bool SidecarFile::replaceMarker(int markerId, const QByteArray &data)
+{
+	const int index = indexOf(markerId);
+	if (index < 0) {
+		return false;
+	}
+
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadWrite)) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to open export file: %s", QT_TO_UTF8(filePath));
+		return false;
+	}
+
+	// Only the bytes after the marker move, everything before it stays untouched
+	const Range range = ranges.at(index);
+	if (!file.seek(range.offset + range.length)) {
+		return false;
+	}
+	const QByteArray tail = file.readAll();
+	const QByteArray bytes = toDiskBytes(data);
+
+	if (!file.seek(range.offset) || file.write(bytes) != bytes.size() || file.write(tail) != tail.size() ||
+	    !file.resize(range.offset + bytes.size() + tail.size())) {
+		blog(LOG_ERROR, "[StreamUP Record Chapter Manager] Failed to rewrite export file: %s", QT_TO_UTF8(filePath));
+		return false;
+	}
+
+	const qint64 delta = bytes.size() - range.length;
+	for (int i = index + 1; i < ranges.size(); ++i) {
+		ranges[i].offset += delta;
+	}
+	if (bytes.isEmpty()) {
+		ranges.removeAt(index);
+	} else {
+		ranges[index].length = bytes.size();
+	}
+	return true;
+}
+
+int SidecarFile::markerTag(int markerId) const
+{
+	const int index = indexOf(markerId);
+	return index < 0 ? 0 : ranges.at(index).tag;
+}
+
+int SidecarFile::indexOf(int markerId) const
+{
+	// Edits nearly always target recent markers, search from the end
+	for (int i = static_cast<int>(ranges.size()) - 1; i >= 0; --i) {
+		if (ranges.at(i).markerId == markerId) {
+			return i;
+		}
+	}
+	return -1;
+}
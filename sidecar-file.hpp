@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef SIDECAR_FILE_HPP
+#define SIDECAR_FILE_HPP
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @class SidecarFile
+ * @brief Append-only export file that remembers the byte range of every marker
+ *
+ * Writers append through this class so each marker's position in the file is
+ * known. Replacing or removing a marker rewrites only the bytes from that
+ * marker to the end of the file, removing the last one is a plain truncate.
+ * Data is written in binary with platform line endings so the recorded
+ * offsets always match the bytes on disk.
+ *
+ * An optional trailer, such as the closing tags of an XML document, stays at
+ * the end of the file. Each append seeks back over it and writes the new data
+ * followed by the trailer again, so the file is complete after every marker.
+ */
+class SidecarFile {
+public:
+	void reset(const QString &newFilePath);
+	// Truncates the file at the current path and writes the header, which is not tracked as a marker
+	bool create(const QByteArray &header);
+	const QString &path() const { return filePath; }
+
+	// markerId < 0 appends bytes that are not tracked, annotations and footers
+	bool append(const QByteArray &data, int markerId = -1, int tag = 0);
+
+	// Writes the trailer after the current content, it is kept at the end until cleared
+	bool setTrailer(const QByteArray &data);
+	// The trailer becomes ordinary content and later appends go after it
+	void clearTrailer() { trailer.clear(); }
+
+	// Rewrites the marker and everything after it, empty data removes the marker
+	bool replaceMarker(int markerId, const QByteArray &data);
+
+	bool hasMarker(int markerId) const { return indexOf(markerId) >= 0; }
+	int markerTag(int markerId) const;
+
+private:
+	struct Range {
+		int markerId;
+		int tag; // Writer defined, EDL event number or template index
+		qint64 offset;
+		qint64 length;
+	};
+
+	int indexOf(int markerId) const;
+	static QByteArray toDiskBytes(const QByteArray &data);
+
+	QString filePath;
+	QVector<Range> ranges;
+	QByteArray trailer; // Disk bytes currently at the end of the file
+};
+
+#endif // SIDECAR_FILE_HPP
@@ -0,0 +1,146 @@
+#include "silence-detector.hpp"
+#include "audio-level.hpp"
+#include <obs-module.h>
+#include <util/platform.h>
+#include <cmath>
+
+#define QT_TO_UTF8(str) str.toUtf8().constData()
+
+namespace {
+
+float meanSquareOf(float db)
+{
+	const float amplitude = std::pow(10.0f, db / 20.0f);
+	return amplitude * amplitude;
+}
+
+} // namespace
+
+SilenceDetector::~SilenceDetector()
+{
+	detach();
+}
+
+bool SilenceDetector::attach(const QString &sourceName, const Settings &newSettings, const Timecode::Timebase &timebase)
+{
+	detach();
+
+	audio_t *audio = obs_get_audio();
+	obs_source_t *audioSource = obs_get_source_by_name(QT_TO_UTF8(sourceName));
+	if (!audio || !audioSource) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Audio source for silence chapters not found: %s", QT_TO_UTF8(sourceName));
+		obs_source_release(audioSource);
+		return false;
+	}
+
+	const uint32_t sampleRate = audio_output_get_sample_rate(audio);
+	silenceMeanSquare = meanSquareOf(newSettings.silenceDb);
+	speechMeanSquare = meanSquareOf(newSettings.speechDb);
+	speechPeak = std::sqrt(speechMeanSquare);
+	minSilenceFrames = static_cast<uint64_t>(newSettings.minSilenceMs) * sampleRate / 1000;
+	minSpeechFrames = static_cast<uint64_t>(newSettings.minSpeechMs) * sampleRate / 1000;
+	channels = audio_output_get_channels(audio);
+	videoTimebase = timebase;
+
+	state = State::Speech;
+	silentFrames = 0;
+	speechFrames = 0;
+	readIndex.store(writeIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	source = audioSource;
+	obs_source_add_audio_capture_callback(source, audioCaptured, this);
+	blog(LOG_INFO, "[StreamUP Record Chapter Manager] Watching %s for silence below %.0f dB", QT_TO_UTF8(sourceName),
+	     newSettings.silenceDb);
+	return true;
+}
+
+void SilenceDetector::detach()
+{
+	if (!source) {
+		return;
+	}
+	// Removing takes the source's callback mutex, no packet is being processed once it returns
+	obs_source_remove_audio_capture_callback(source, audioCaptured, this);
+	obs_source_release(source);
+	source = nullptr;
+}
+
+bool SilenceDetector::takeSpeechOnset(uint64_t &totalFrames)
+{
+	const uint32_t read = readIndex.load(std::memory_order_relaxed);
+	if (read == writeIndex.load(std::memory_order_acquire)) {
+		return false;
+	}
+	totalFrames = onsets[read % QUEUE_SIZE];
+	readIndex.store(read + 1, std::memory_order_release);
+	return true;
+}
+
+void SilenceDetector::audioCaptured(void *param, obs_source_t *, const struct audio_data *audio, bool muted)
+{
+	static_cast<SilenceDetector *>(param)->process(audio, muted);
+}
+
+void SilenceDetector::process(const struct audio_data *audio, bool muted)
+{
+	if (!audio->frames) {
+		return;
+	}
+
+	bool silent = muted;
+	bool speech = false;
+	if (!muted) {
+		// OBS mixes in planar float, one plane per channel
+		AudioLevel::Level level;
+		for (size_t channel = 0; channel < channels && channel < MAX_AV_PLANES; ++channel) {
+			if (audio->data[channel]) {
+				AudioLevel::accumulate(level, reinterpret_cast<const float *>(audio->data[channel]), audio->frames);
+			}
+		}
+		const float meanSquare = level.samples ? level.sumSquares / static_cast<float>(level.samples) : 0.0f;
+		silent = meanSquare < silenceMeanSquare && level.peak < speechPeak;
+		speech = meanSquare >= speechMeanSquare;
+	}
+
+	switch (state) {
+	case State::Speech:
+		silentFrames = silent ? silentFrames + audio->frames : 0;
+		if (silentFrames >= minSilenceFrames) {
+			state = State::Silence;
+			speechFrames = 0;
+		}
+		break;
+	case State::Silence:
+		if (speech) {
+			if (speechFrames == 0) {
+				speechStartNs = audio->timestamp;
+			}
+			speechFrames += audio->frames;
+			if (speechFrames >= minSpeechFrames) {
+				pushOnset(speechStartNs);
+				state = State::Speech;
+				silentFrames = 0;
+			}
+		} else if (silent) {
+			// A cough or a click, the silence goes on
+			speechFrames = 0;
+		}
+		break;
+	}
+}
+
+void SilenceDetector::pushOnset(uint64_t timestampNs)
+{
+	// Audio lags the video, step back from the current frame by how long ago the speech began
+	const uint64_t nowNs = os_gettime_ns();
+	const uint64_t agoNs = nowNs > timestampNs ? nowNs - timestampNs : 0;
+	const uint64_t framesAgo = videoTimebase.fpsDen ? agoNs / 1000 * videoTimebase.fpsNum / videoTimebase.fpsDen / 1000000 : 0;
+	const uint64_t totalFrames = obs_get_total_frames();
+
+	const uint32_t write = writeIndex.load(std::memory_order_relaxed);
+	if (write - readIndex.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+		return;
+	}
+	onsets[write % QUEUE_SIZE] = totalFrames > framesAgo ? totalFrames - framesAgo : 0;
+	writeIndex.store(write + 1, std::memory_order_release);
+}
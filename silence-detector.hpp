@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef SILENCE_DETECTOR_HPP
+#define SILENCE_DETECTOR_HPP
+
+#include "timecode-format.hpp"
+#include <obs.h>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class SilenceDetector
+ * @brief Finds speech that follows a long silence on one audio source
+ *
+ * Attaches an audio capture callback to the source and measures every packet
+ * on the audio thread with AudioLevel. A small state machine with hysteresis
+ * decides between silence and speech: a packet is silent when its RMS is
+ * below the silence threshold and no sample reaches the speech threshold, and
+ * speech when its RMS reaches the speech threshold, which sits a few dB
+ * higher. Levels in between keep the current state, so a voice trailing off
+ * or a noise floor near the threshold does not flap.
+ *
+ * Once silence has lasted minSilenceMs and speech then holds for
+ * minSpeechMs, the position where that speech began is handed to the UI
+ * thread as an OBS frame count through a fixed lock-free queue. The callback
+ * never allocates or locks.
+ */
+class SilenceDetector {
+public:
+	struct Settings {
+		float silenceDb = -45.0f;
+		float speechDb = -35.0f;
+		int minSilenceMs = 3000;
+		int minSpeechMs = 250;
+	};
+
+	static constexpr uint32_t QUEUE_SIZE = 16; // Power of two, onsets beyond it are dropped
+
+	~SilenceDetector();
+
+	// UI thread, looks the source up by name and starts from the speech state
+	bool attach(const QString &sourceName, const Settings &newSettings, const Timecode::Timebase &timebase);
+	void detach();
+	bool isAttached() const { return source != nullptr; }
+
+	// UI thread, the OBS frame count (obs_get_total_frames) where speech resumed
+	bool takeSpeechOnset(uint64_t &totalFrames);
+
+private:
+	enum class State { Speech, Silence };
+
+	static void audioCaptured(void *param, obs_source_t *source, const struct audio_data *audio, bool muted);
+	void process(const struct audio_data *audio, bool muted);
+	void pushOnset(uint64_t timestampNs);
+
+	obs_source_t *source = nullptr;
+
+	// Set before the callback is added, only read on the audio thread afterwards
+	float silenceMeanSquare = 0.0f;
+	float speechMeanSquare = 0.0f;
+	float speechPeak = 0.0f;
+	uint64_t minSilenceFrames = 0;
+	uint64_t minSpeechFrames = 0;
+	size_t channels = 0;
+	Timecode::Timebase videoTimebase;
+
+	// Audio thread only
+	State state = State::Speech;
+	uint64_t silentFrames = 0;
+	uint64_t speechFrames = 0;
+	uint64_t speechStartNs = 0;
+
+	// Single producer (audio thread), single consumer (UI thread)
+	uint64_t onsets[QUEUE_SIZE] = {};
+	std::atomic<uint32_t> writeIndex{0};
+	std::atomic<uint32_t> readIndex{0};
+};
+
+#endif // SILENCE_DETECTOR_HPP
@@ -0,0 +1,716 @@
+#include "chapter-export.hpp"
+#include "chapter-index.hpp"
+#include "constants.hpp"
+#include "marker-source.hpp"
+#include <QAtomicInteger>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#define QT_TO_UTF8(str) str.toUtf8().constData()
+
+/*
+ * Regenerates chapter sidecars for recorded sessions from their binary
+ * chapter index (_chapters.chidx), using the same formatting code as the
+ * plugin. Each recording is one task on a thread pool, idle threads pick up
+ * the next recording until the queue is empty.
+ *
+ * With --merge the sessions of several OBS instances are lined up on the
+ * anchors stored in their index headers and written as one timeline, one
+ * track per instance. The inputs are merged record by record straight from
+ * their mappings, so memory does not grow with the number of markers.
+ */
+
+namespace {
+
+// Sessions whose wall-clock and monotonic clocks differ by the same amount ran on the same machine
+constexpr int64_t SAME_HOST_TOLERANCE_NS = 1000000000;
+constexpr int DEFAULT_DEDUPE_WINDOW_MS = 500;
+
+struct ConvertOptions {
+	bool text = false;
+	bool fcpXml = false;
+	bool premiereXml = false;
+	bool edl = false;
+	bool custom = false;
+	bool addSource = false;
+	bool rescale = false; // Convert frame offsets to the timebase below
+	Timecode::Timebase timebase;
+	ExportTemplate exportTemplate;
+	QString outputDirectory;
+};
+
+struct MergeOptions {
+	QString outputBasePath;
+	QStringList labels;
+	QString clock; // auto, monotonic or wall
+	int64_t dedupeWindowNs = 0;
+};
+
+struct IndexMarker {
+	uint64_t frameOffset = 0;
+	MarkerSource::Kind kind = MarkerSource::Kind::Manual;
+	bool annotation = false;
+	QString name;
+	QString source;
+};
+
+struct Totals {
+	QAtomicInteger<int> recordings = 0;
+	QAtomicInteger<int> failures = 0;
+	QAtomicInteger<qint64> markers = 0;
+	QAtomicInteger<qint64> filesWritten = 0;
+	QAtomicInteger<qint64> bytesWritten = 0;
+};
+
+QMutex outputMutex;
+
+void printLine(FILE *stream, const QString &line)
+{
+	// Tasks report from several threads, keep each line whole
+	QMutexLocker locker(&outputMutex);
+	fprintf(stream, "%s\n", QT_TO_UTF8(line));
+}
+
+QString indexBaseName(const QString &indexPath)
+{
+	const QString fileName = QFileInfo(indexPath).fileName();
+	return fileName.endsWith(Constants::CHAPTER_INDEX_FILE_SUFFIX)
+		       ? fileName.chopped(static_cast<qsizetype>(strlen(Constants::CHAPTER_INDEX_FILE_SUFFIX)))
+		       : QFileInfo(indexPath).completeBaseName();
+}
+
+// False for records deleted during the recording
+bool readMarker(const ChapterIndexReader &reader, uint32_t index, IndexMarker &marker)
+{
+	const ChapterIndex::Record record = reader.record(index);
+	if (record.flags & ChapterIndex::RecordDeleted) {
+		return false;
+	}
+
+	// Kinds added by a newer plugin are exported like client supplied sources
+	marker.frameOffset = record.frameOffset;
+	marker.kind = record.sourceKind < MarkerSource::KIND_COUNT ? static_cast<MarkerSource::Kind>(record.sourceKind)
+								   : MarkerSource::Kind::Custom;
+	marker.annotation = (record.flags & ChapterIndex::RecordAnnotation) != 0;
+	marker.name = reader.string(record.nameOffset, record.nameLength);
+	marker.source = reader.string(record.sourceOffset, record.sourceLength);
+	return true;
+}
+
+uint64_t rescaleFrame(uint64_t frameOffset, const Timecode::Timebase &from, const Timecode::Timebase &to)
+{
+	// Same point in time at the new rate, rounded to the nearest frame
+	const uint64_t numerator = static_cast<uint64_t>(to.fpsNum) * from.fpsDen;
+	const uint64_t denominator = static_cast<uint64_t>(from.fpsNum) * to.fpsDen;
+	if (denominator == 0) {
+		return frameOffset;
+	}
+	return (frameOffset * numerator + denominator / 2) / denominator;
+}
+
+int64_t framesToNanoseconds(uint64_t frameOffset, const Timecode::Timebase &timebase)
+{
+	return timebase.fpsNum == 0 ? 0
+				    : std::llround(static_cast<double>(frameOffset) * 1e9 * timebase.fpsDen / timebase.fpsNum);
+}
+
+uint64_t nanosecondsToFrames(int64_t nanoseconds, const Timecode::Timebase &timebase)
+{
+	return nanoseconds <= 0 || timebase.fpsDen == 0
+		       ? 0
+		       : static_cast<uint64_t>(std::llround(static_cast<double>(nanoseconds) * timebase.fpsNum /
+							    (1e9 * timebase.fpsDen)));
+}
+
+/**
+ * Output file written piece by piece and swapped in on commit, so an
+ * interrupted run never leaves a half-written export behind.
+ */
+class StreamedFile {
+public:
+	explicit StreamedFile(const QString &filePath) : file(filePath) {}
+
+	bool open() { return file.open(QIODevice::WriteOnly); }
+
+	void write(QByteArray data)
+	{
+#ifdef _WIN32
+		// Same line endings the plugin writes live
+		data.replace("\n", "\r\n");
+#endif
+		// QSaveFile remembers a failed write and refuses to commit
+		file.write(data);
+		bytes += data.size();
+	}
+
+	bool commit(Totals &totals)
+	{
+		if (!file.commit()) {
+			printLine(stderr, QString("Failed to write %1: %2").arg(file.fileName(), file.errorString()));
+			return false;
+		}
+		totals.filesWritten.fetchAndAddRelaxed(1);
+		totals.bytesWritten.fetchAndAddRelaxed(bytes);
+		return true;
+	}
+
+private:
+	QSaveFile file;
+	qint64 bytes = 0;
+};
+
+/**
+ * Writes one timeline in every selected format at the same time, markers
+ * must be added in time order.
+ */
+class TimelineWriter {
+public:
+	TimelineWriter(const ConvertOptions &convertOptions, Totals &runTotals) : options(convertOptions), totals(runTotals) {}
+
+	bool open(const QString &outputBasePath, const QString &timelineTitle, const Timecode::Timebase &outputTimebase);
+	// trackLabel is prefixed to the names of merged timelines, reelNumber is the EDL reel of the track
+	void add(const IndexMarker &marker, uint64_t frameOffset, const QString &trackLabel = QString(), int reelNumber = 1);
+	bool close(uint64_t endFrame);
+
+private:
+	std::unique_ptr<StreamedFile> openFile(const QString &filePath);
+	void rollOverEdl(uint64_t frameOffset);
+
+	const ConvertOptions &options;
+	Totals &totals;
+	QString basePath;
+	QString title;
+	Timecode::Timebase timebase;
+	bool ok = true;
+
+	std::unique_ptr<StreamedFile> text;
+	std::unique_ptr<StreamedFile> fcpXml;
+	std::unique_ptr<StreamedFile> premiereXml;
+	std::unique_ptr<StreamedFile> edl;
+	std::unique_ptr<StreamedFile> custom;
+
+	int edlPartNumber = 1;
+	int edlEventNumber = 1;
+	QString edlManifest;
+
+	QString templateFieldValues[ExportTemplate::FieldCount];
+	QByteArray templateRenderBuffer;
+	int templateMarkerIndex = 1;
+};
+
+std::unique_ptr<StreamedFile> TimelineWriter::openFile(const QString &filePath)
+{
+	auto file = std::make_unique<StreamedFile>(filePath);
+	if (!file->open()) {
+		printLine(stderr, QString("Failed to create %1").arg(filePath));
+		ok = false;
+		return nullptr;
+	}
+	return file;
+}
+
+bool TimelineWriter::open(const QString &outputBasePath, const QString &timelineTitle, const Timecode::Timebase &outputTimebase)
+{
+	basePath = outputBasePath;
+	title = timelineTitle;
+	timebase = outputTimebase;
+
+	if (options.text && (text = openFile(basePath + Constants::TEXT_FILE_SUFFIX))) {
+		text->write(ChapterExport::textHeader(title));
+	}
+	if (options.fcpXml && (fcpXml = openFile(basePath + Constants::FCPXML_FILE_SUFFIX))) {
+		fcpXml->write(ChapterExport::fcpXmlHeader(title, timebase));
+	}
+	if (options.premiereXml && (premiereXml = openFile(basePath + Constants::PREMIEREXML_FILE_SUFFIX))) {
+		premiereXml->write(ChapterExport::premiereXmlHeader(title, timebase));
+	}
+	if (options.edl && (edl = openFile(basePath + Constants::EDL_FILE_SUFFIX))) {
+		edl->write(ChapterExport::edlHeader(title));
+	}
+	if (options.custom && (custom = openFile(basePath + options.exportTemplate.fileSuffix))) {
+		ChapterExport::setTemplateFields(templateFieldValues, options.exportTemplate, title, 0, QString(),
+						 templateMarkerIndex, timebase);
+		custom->write(ChapterExport::renderTemplate(options.exportTemplate.header, templateFieldValues,
+							    templateRenderBuffer));
+	}
+	return ok;
+}
+
+void TimelineWriter::add(const IndexMarker &marker, uint64_t frameOffset, const QString &trackLabel, int reelNumber)
+{
+	const QString chapterName = trackLabel.isEmpty() ? marker.name : "[" + trackLabel + "] " + marker.name;
+	// Matches the line the plugin writes for an annotation, without the store reference
+	const QString name = marker.annotation ? "(Annotation) " + chapterName + " (" + marker.source + ")" : chapterName;
+	const QString fullName = ChapterExport::fullName(name, marker.source, options.addSource);
+
+	if (text) {
+		text->write(ChapterExport::textMarker(fullName, frameOffset, timebase));
+	}
+	if (fcpXml) {
+		fcpXml->write(ChapterExport::fcpXmlMarker(name, fullName, frameOffset));
+	}
+	if (premiereXml) {
+		premiereXml->write(ChapterExport::premiereXmlMarker(fullName, frameOffset));
+	}
+
+	// Annotations are not exported to EDL
+	if (edl && !marker.annotation) {
+		if (edlEventNumber > Constants::EDL_MAX_EVENTS) {
+			rollOverEdl(frameOffset);
+		}
+		if (edl) {
+			edl->write(ChapterExport::edlMarker(name, fullName, frameOffset, timebase, edlEventNumber,
+							    MarkerSource::info(marker.kind).edlColor, reelNumber));
+			edlEventNumber++;
+		}
+	}
+
+	if (custom) {
+		ChapterExport::setTemplateFields(templateFieldValues, options.exportTemplate, chapterName, frameOffset,
+						 marker.source, templateMarkerIndex, timebase);
+		custom->write(ChapterExport::renderTemplate(marker.annotation ? options.exportTemplate.annotation
+									      : options.exportTemplate.marker,
+							    templateFieldValues, templateRenderBuffer));
+		templateMarkerIndex++;
+	}
+}
+
+void TimelineWriter::rollOverEdl(uint64_t frameOffset)
+{
+	// Same part files and manifest the plugin writes at the CMX3600 event limit
+	ok = edl->commit(totals) && ok;
+	if (edlPartNumber == 1) {
+		edlManifest += QString("EDL parts for %1\n").arg(title);
+		edlManifest += QString("001 - %1 %2\n").arg(QString(Constants::DEFAULT_TIMESTAMP), title + Constants::EDL_FILE_SUFFIX);
+	}
+
+	edlPartNumber++;
+	const QString partSuffix = QString("_%1").arg(edlPartNumber, 3, 10, QChar('0'));
+	const QString partFilePath = basePath + "_chapters" + partSuffix + ".edl";
+	char timestamp[Timecode::BUFFER_SIZE];
+	const QString startTime =
+		QString::fromLatin1(timestamp, static_cast<qsizetype>(Timecode::formatHms(timestamp, frameOffset, timebase)));
+	edlManifest += QString("%1 - %2 %3\n").arg(edlPartNumber, 3, 10, QChar('0')).arg(startTime, QFileInfo(partFilePath).fileName());
+
+	edlEventNumber = 1;
+	if ((edl = openFile(partFilePath))) {
+		edl->write(ChapterExport::edlHeader(QString("%1 (Part %2)").arg(title).arg(edlPartNumber)));
+	}
+}
+
+bool TimelineWriter::close(uint64_t endFrame)
+{
+	if (text) {
+		ok = text->commit(totals) && ok;
+	}
+	if (fcpXml) {
+		fcpXml->write(ChapterExport::FCPXML_FOOTER);
+		ok = fcpXml->commit(totals) && ok;
+	}
+	if (premiereXml) {
+		premiereXml->write(ChapterExport::PREMIEREXML_FOOTER);
+		ok = premiereXml->commit(totals) && ok;
+	}
+	if (edl) {
+		ok = edl->commit(totals) && ok;
+	}
+	if (!edlManifest.isEmpty()) {
+		std::unique_ptr<StreamedFile> manifest = openFile(basePath + Constants::EDL_MANIFEST_FILE_SUFFIX);
+		if (manifest) {
+			manifest->write(edlManifest.toUtf8());
+			ok = manifest->commit(totals) && ok;
+		}
+	}
+	if (custom) {
+		ChapterExport::setTemplateFields(templateFieldValues, options.exportTemplate, title, endFrame, QString(),
+						 templateMarkerIndex, timebase);
+		custom->write(ChapterExport::renderTemplate(options.exportTemplate.footer, templateFieldValues,
+							    templateRenderBuffer));
+		ok = custom->commit(totals) && ok;
+	}
+	return ok;
+}
+
+bool convertRecording(const QString &indexPath, const ConvertOptions &options, Totals &totals)
+{
+	ChapterIndexReader reader;
+	if (!reader.open(indexPath)) {
+		printLine(stderr, QString("Skipped %1: %2").arg(indexPath, reader.errorString()));
+		return false;
+	}
+	if (!reader.isComplete()) {
+		printLine(stderr, QString("Warning: %1 was not closed, converting the markers written so far").arg(indexPath));
+	}
+
+	const Timecode::Timebase sourceTimebase = reader.timebase();
+	const Timecode::Timebase timebase = options.rescale ? options.timebase : sourceTimebase;
+	const QString baseName = indexBaseName(indexPath);
+	const QString directoryPath = options.outputDirectory.isEmpty() ? QFileInfo(indexPath).absolutePath()
+									: options.outputDirectory;
+
+	TimelineWriter writer(options, totals);
+	bool ok = writer.open(directoryPath + "/" + baseName, baseName, timebase);
+
+	IndexMarker marker;
+	uint64_t frameOffset = 0;
+	qint64 markerCount = 0;
+	for (uint32_t i = 0; i < reader.recordCount(); ++i) {
+		if (!readMarker(reader, i, marker)) {
+			continue;
+		}
+		frameOffset = options.rescale ? rescaleFrame(marker.frameOffset, sourceTimebase, timebase) : marker.frameOffset;
+		writer.add(marker, frameOffset);
+		markerCount++;
+	}
+	ok = writer.close(frameOffset) && ok;
+
+	totals.recordings.fetchAndAddRelaxed(1);
+	totals.markers.fetchAndAddRelaxed(markerCount);
+	return ok;
+}
+
+//--------------------MERGE--------------------
+struct MergeTrack {
+	ChapterIndexReader reader;
+	QString label;
+	int reelNumber = 1;
+	int64_t startNs = 0; // Session start on the merged timeline
+	uint32_t nextRecord = 0;
+	IndexMarker pending; // Next marker of this track, not yet merged
+	int64_t pendingNs = 0;
+};
+
+bool loadNextMarker(MergeTrack &track)
+{
+	while (track.nextRecord < track.reader.recordCount()) {
+		if (readMarker(track.reader, track.nextRecord++, track.pending)) {
+			track.pendingNs = track.startNs + framesToNanoseconds(track.pending.frameOffset, track.reader.timebase());
+			return true;
+		}
+	}
+	return false;
+}
+
+bool mergeRecordings(const QStringList &indexFiles, const ConvertOptions &options, const MergeOptions &merge, Totals &totals)
+{
+	std::vector<std::unique_ptr<MergeTrack>> tracks;
+	for (const QString &indexPath : indexFiles) {
+		auto track = std::make_unique<MergeTrack>();
+		if (!track->reader.open(indexPath)) {
+			printLine(stderr, QString("Skipped %1: %2").arg(indexPath, track->reader.errorString()));
+			totals.failures.fetchAndAddRelaxed(1);
+			continue;
+		}
+		if (track->reader.anchor().wallClockNs == 0) {
+			printLine(stderr, QString("Skipped %1: recorded without a session anchor").arg(indexPath));
+			totals.failures.fetchAndAddRelaxed(1);
+			continue;
+		}
+		if (!track->reader.isComplete()) {
+			printLine(stderr, QString("Warning: %1 was not closed, merging the markers written so far").arg(indexPath));
+		}
+		track->label = merge.labels.value(static_cast<qsizetype>(tracks.size()), indexBaseName(indexPath));
+		track->reelNumber = static_cast<int>(tracks.size()) + 1;
+		tracks.push_back(std::move(track));
+	}
+	if (tracks.empty()) {
+		return false;
+	}
+
+	// The monotonic clock has no NTP steps but only compares within one machine
+	bool useMonotonic = merge.clock == "monotonic";
+	if (merge.clock == "auto") {
+		int64_t minOffset = INT64_MAX;
+		int64_t maxOffset = INT64_MIN;
+		for (const auto &track : tracks) {
+			const ChapterIndex::SessionAnchor anchor = track->reader.anchor();
+			const int64_t offset = anchor.wallClockNs - static_cast<int64_t>(anchor.monotonicNs);
+			minOffset = std::min(minOffset, offset);
+			maxOffset = std::max(maxOffset, offset);
+		}
+		useMonotonic = maxOffset - minOffset < SAME_HOST_TOLERANCE_NS;
+	}
+
+	int64_t originNs = INT64_MAX;
+	for (const auto &track : tracks) {
+		const ChapterIndex::SessionAnchor anchor = track->reader.anchor();
+		track->startNs = useMonotonic ? static_cast<int64_t>(anchor.monotonicNs) : anchor.wallClockNs;
+		originNs = std::min(originNs, track->startNs);
+	}
+
+	// Min-heap of each track's next marker, ties go to the earlier track so output is stable
+	using HeapEntry = std::pair<int64_t, size_t>;
+	std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+	for (size_t i = 0; i < tracks.size(); ++i) {
+		tracks[i]->startNs -= originNs;
+		if (loadNextMarker(*tracks[i])) {
+			heap.push({tracks[i]->pendingNs, i});
+		}
+	}
+
+	const Timecode::Timebase timebase = options.rescale ? options.timebase : tracks.front()->reader.timebase();
+	const QString title = QFileInfo(merge.outputBasePath).fileName();
+	TimelineWriter writer(options, totals);
+	bool ok = writer.open(merge.outputBasePath, title, timebase);
+
+	// Markers already written inside the dedupe window, the same name from another track is dropped
+	struct RecentMarker {
+		int64_t timeNs;
+		size_t track;
+		QString key;
+	};
+	std::deque<RecentMarker> recent;
+	uint64_t frameOffset = 0;
+	qint64 merged = 0;
+	qint64 duplicates = 0;
+
+	while (!heap.empty()) {
+		const HeapEntry top = heap.top();
+		heap.pop();
+		MergeTrack &track = *tracks[top.second];
+		const IndexMarker marker = track.pending;
+		if (loadNextMarker(track)) {
+			heap.push({track.pendingNs, top.second});
+		}
+
+		while (!recent.empty() && top.first - recent.front().timeNs > merge.dedupeWindowNs) {
+			recent.pop_front();
+		}
+		const QString key = marker.name.toCaseFolded();
+		const bool duplicate = std::any_of(recent.begin(), recent.end(), [&](const RecentMarker &entry) {
+			return entry.track != top.second && entry.key == key;
+		});
+		if (duplicate) {
+			duplicates++;
+			continue;
+		}
+		recent.push_back({top.first, top.second, key});
+
+		frameOffset = nanosecondsToFrames(top.first, timebase);
+		writer.add(marker, frameOffset, track.label, track.reelNumber);
+		merged++;
+	}
+	ok = writer.close(frameOffset) && ok;
+
+	printLine(stdout, QString("Merged %1 markers from %2 sessions on the %3 clock, dropped %4 near-simultaneous duplicates")
+				  .arg(merged)
+				  .arg(tracks.size())
+				  .arg(useMonotonic ? "monotonic" : "wall")
+				  .arg(duplicates));
+	totals.recordings.fetchAndAddRelaxed(static_cast<int>(tracks.size()));
+	totals.markers.fetchAndAddRelaxed(merged);
+	return ok;
+}
+
+bool parseTimebase(const QString &text, Timecode::Timebase &timebase)
+{
+	// Either a rate such as 60 or a fraction such as 30000/1001
+	const QStringList parts = text.split('/');
+	bool numOk = false;
+	bool denOk = parts.size() == 1;
+	const uint32_t fpsNum = parts.value(0).toUInt(&numOk);
+	const uint32_t fpsDen = parts.size() == 2 ? parts.value(1).toUInt(&denOk) : 1;
+	if (parts.size() > 2 || !numOk || !denOk || fpsNum == 0 || fpsDen == 0) {
+		return false;
+	}
+	timebase = {fpsNum, fpsDen};
+	return true;
+}
+
+void collectIndexFiles(const QString &path, QStringList &indexFiles)
+{
+	if (!QFileInfo(path).isDir()) {
+		indexFiles.append(path);
+		return;
+	}
+
+	// Sorted so merged tracks get the same reel numbers on every run
+	QStringList found;
+	QDirIterator it(path, {QString("*") + Constants::CHAPTER_INDEX_FILE_SUFFIX}, QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext()) {
+		found.append(it.next());
+	}
+	found.sort();
+	indexFiles += found;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName("streamup-chapter-convert");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Regenerates chapter export files from StreamUP chapter index files.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("paths", "Chapter index files, or folders searched recursively for them.", "<paths...>");
+
+	const QCommandLineOption formatsOption("formats", "Comma separated list of text, fcpxml, premierexml, edl, template.",
+					       "list", "text");
+	const QCommandLineOption fpsOption("fps", "Re-time markers to this frame rate, for example 60 or 30000/1001.", "rate");
+	const QCommandLineOption addSourceOption("add-source", "Append the marker source to chapter names.");
+	const QCommandLineOption outputOption("output-dir", "Write files here instead of next to each index.", "dir");
+	const QCommandLineOption jobsOption("jobs", "Number of recordings converted at once, defaults to the core count.", "count");
+	const QCommandLineOption mergeOption("merge", "Merge all inputs into one timeline written to this path and file name prefix.",
+					     "path");
+	const QCommandLineOption labelsOption("labels", "Comma separated track names for --merge, in input order.", "list");
+	const QCommandLineOption clockOption("clock", "Clock used to line up merged sessions: auto, monotonic or wall.", "clock",
+					     "auto");
+	const QCommandLineOption dedupeOption("dedupe-ms", "Drop a merged marker when another track has the same name this close.",
+					      "ms", QString::number(DEFAULT_DEDUPE_WINDOW_MS));
+	const QCommandLineOption suffixOption("template-suffix", "File suffix of the custom template export.", "suffix",
+					      Constants::TEMPLATE_FILE_SUFFIX);
+	const QCommandLineOption escapeOption("template-escape", "Default escaping of template fields: none, xml or json.", "mode",
+					      "none");
+	const QCommandLineOption headerOption("template-header", "Custom template header line.", "template");
+	const QCommandLineOption markerOption("template-marker", "Custom template marker line.", "template",
+					      Constants::DEFAULT_TEMPLATE_LINE);
+	const QCommandLineOption annotationOption("template-annotation", "Custom template annotation line.", "template",
+						  Constants::DEFAULT_TEMPLATE_LINE);
+	const QCommandLineOption footerOption("template-footer", "Custom template footer line.", "template");
+	parser.addOptions({formatsOption, fpsOption, addSourceOption, outputOption, jobsOption, mergeOption, labelsOption,
+			   clockOption, dedupeOption, suffixOption, escapeOption, headerOption, markerOption, annotationOption,
+			   footerOption});
+	parser.process(app);
+
+	ConvertOptions options;
+	for (const QString &format : parser.value(formatsOption).split(',', Qt::SkipEmptyParts)) {
+		const QString name = format.trimmed().toLower();
+		if (name == "text") {
+			options.text = true;
+		} else if (name == "fcpxml") {
+			options.fcpXml = true;
+		} else if (name == "premierexml") {
+			options.premiereXml = true;
+		} else if (name == "edl") {
+			options.edl = true;
+		} else if (name == "template") {
+			options.custom = true;
+		} else {
+			printLine(stderr, QString("Unknown format: %1").arg(format));
+			return 2;
+		}
+	}
+
+	if (parser.isSet(fpsOption)) {
+		if (!parseTimebase(parser.value(fpsOption), options.timebase)) {
+			printLine(stderr, QString("Invalid frame rate: %1").arg(parser.value(fpsOption)));
+			return 2;
+		}
+		options.rescale = true;
+	}
+
+	options.addSource = parser.isSet(addSourceOption);
+	if (parser.isSet(outputOption)) {
+		options.outputDirectory = QDir(parser.value(outputOption)).absolutePath();
+		if (!QDir().mkpath(options.outputDirectory)) {
+			printLine(stderr, QString("Could not create output folder: %1").arg(options.outputDirectory));
+			return 2;
+		}
+	}
+
+	MergeOptions merge;
+	if (parser.isSet(mergeOption)) {
+		merge.outputBasePath = QFileInfo(parser.value(mergeOption)).absoluteFilePath();
+		merge.labels = parser.value(labelsOption).split(',', Qt::SkipEmptyParts);
+		merge.clock = parser.value(clockOption).toLower();
+		bool dedupeOk = false;
+		const int dedupeMs = parser.value(dedupeOption).toInt(&dedupeOk);
+		if (merge.clock != "auto" && merge.clock != "monotonic" && merge.clock != "wall") {
+			printLine(stderr, QString("Unknown clock: %1").arg(parser.value(clockOption)));
+			return 2;
+		}
+		if (!dedupeOk || dedupeMs < 0) {
+			printLine(stderr, QString("Invalid dedupe window: %1").arg(parser.value(dedupeOption)));
+			return 2;
+		}
+		merge.dedupeWindowNs = static_cast<int64_t>(dedupeMs) * 1000000;
+		if (!QDir().mkpath(QFileInfo(merge.outputBasePath).absolutePath())) {
+			printLine(stderr, QString("Could not create output folder: %1").arg(QFileInfo(merge.outputBasePath).absolutePath()));
+			return 2;
+		}
+	}
+
+	options.exportTemplate.fileSuffix = parser.value(suffixOption);
+	options.exportTemplate.escapeName = parser.value(escapeOption);
+	options.exportTemplate.headerSource = parser.value(headerOption);
+	options.exportTemplate.markerSource = parser.value(markerOption);
+	options.exportTemplate.annotationSource = parser.value(annotationOption);
+	options.exportTemplate.footerSource = parser.value(footerOption);
+	if (options.custom && !options.exportTemplate.compile()) {
+		printLine(stderr, QString("Invalid template: %1").arg(options.exportTemplate.errorString()));
+		return 2;
+	}
+
+	QStringList indexFiles;
+	for (const QString &path : parser.positionalArguments()) {
+		collectIndexFiles(path, indexFiles);
+	}
+	if (indexFiles.isEmpty()) {
+		parser.showHelp(2);
+	}
+
+	Totals totals;
+	QElapsedTimer timer;
+	timer.start();
+	int threadCount = 1;
+
+	if (!merge.outputBasePath.isEmpty()) {
+		// One streaming pass over all inputs
+		if (!mergeRecordings(indexFiles, options, merge, totals)) {
+			totals.failures.fetchAndAddRelaxed(1);
+		}
+	} else {
+		QThreadPool pool;
+		if (parser.isSet(jobsOption)) {
+			pool.setMaxThreadCount(qMax(1, parser.value(jobsOption).toInt()));
+		}
+		threadCount = pool.maxThreadCount();
+
+		// Largest indexes first, so a long recording does not start last and hold up the end of the run
+		std::sort(indexFiles.begin(), indexFiles.end(),
+			  [](const QString &a, const QString &b) { return QFileInfo(a).size() > QFileInfo(b).size(); });
+
+		for (const QString &indexPath : indexFiles) {
+			pool.start([indexPath, &options, &totals]() {
+				if (!convertRecording(indexPath, options, totals)) {
+					totals.failures.fetchAndAddRelaxed(1);
+				}
+			});
+		}
+		pool.waitForDone();
+	}
+
+	const double seconds = qMax<qint64>(timer.elapsed(), 1) / 1000.0;
+	const int recordings = totals.recordings.loadRelaxed();
+	const qint64 markers = totals.markers.loadRelaxed();
+	printLine(stdout, QString("Converted %1 of %2 recordings with %3 threads in %4 s")
+				  .arg(recordings)
+				  .arg(indexFiles.size())
+				  .arg(threadCount)
+				  .arg(seconds, 0, 'f', 2));
+	printLine(stdout, QString("%1 recordings/s, %2 markers/s, %3 files, %4 MB written")
+				  .arg(recordings / seconds, 0, 'f', 1)
+				  .arg(markers / seconds, 0, 'f', 0)
+				  .arg(totals.filesWritten.loadRelaxed())
+				  .arg(totals.bytesWritten.loadRelaxed() / (1024.0 * 1024.0), 0, 'f', 2));
+
+	return totals.failures.loadRelaxed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+#include "chapter-state.hpp"
+#include "constants.hpp"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+
+#define QT_TO_UTF8(str) str.toUtf8().constData()
+
+/*
+ * Prints the current chapter that a running plugin publishes in shared
+ * memory, as one line of JSON. With --watch a line is printed every time the
+ * plugin updates the block, which is enough to feed an overlay from a pipe
+ * or a small local web server without a WebSocket connection.
+ */
+
+namespace {
+
+constexpr int DEFAULT_INTERVAL_MS = 100;
+
+QByteArray snapshotLine(const ChapterState::Snapshot &snapshot)
+{
+	const QJsonObject object{{"sequence", static_cast<qint64>(snapshot.sequence)},
+				 {"recording", snapshot.recording},
+				 {"markerId", snapshot.markerId},
+				 {"chapterNumber", snapshot.chapterNumber},
+				 {"chapterName", snapshot.chapterName},
+				 {"chapterStartMs", snapshot.chapterStartMs},
+				 {"recordingStartedAtMs", snapshot.recordingStartedAtMs}};
+	return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName("streamup-chapter-state");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Prints the current chapter published by the StreamUP Record Chapter Manager plugin.");
+	parser.addHelpOption();
+	const QCommandLineOption watchOption("watch", "Keep running and print a line whenever the chapter changes.");
+	const QCommandLineOption intervalOption("interval", "How often --watch looks for changes.", "ms",
+						QString::number(DEFAULT_INTERVAL_MS));
+	parser.addOptions({watchOption, intervalOption});
+	parser.process(app);
+
+	const int intervalMs = std::max(1, parser.value(intervalOption).toInt());
+	const bool watch = parser.isSet(watchOption);
+
+	QSharedMemory memory;
+	ChapterState::setKey(memory, Constants::CHAPTER_STATE_KEY);
+	uint32_t lastSequence = 0;
+	bool printedAny = false;
+
+	for (;;) {
+		if (!memory.isAttached() && !memory.attach(QSharedMemory::ReadOnly)) {
+			if (!watch) {
+				fprintf(stderr, "OBS is not running or the plugin is not loaded: %s\n", QT_TO_UTF8(memory.errorString()));
+				return 1;
+			}
+			QThread::msleep(static_cast<unsigned long>(intervalMs) * 10);
+			continue;
+		}
+
+		ChapterState::Snapshot snapshot;
+		const auto *block = static_cast<const ChapterState::Block *>(memory.constData());
+		if (memory.size() < static_cast<qsizetype>(sizeof(ChapterState::Block)) || !ChapterState::read(block, snapshot)) {
+			if (!watch) {
+				fprintf(stderr, "The chapter state block could not be read\n");
+				return 1;
+			}
+			// A block from another plugin version, or OBS restarted and made a new one
+			memory.detach();
+			QThread::msleep(static_cast<unsigned long>(intervalMs));
+			continue;
+		}
+
+		if (!printedAny || snapshot.sequence != lastSequence) {
+			printf("%s\n", snapshotLine(snapshot).constData());
+			fflush(stdout);
+			lastSequence = snapshot.sequence;
+			printedAny = true;
+		}
+		if (!watch) {
+			return 0;
+		}
+		QThread::msleep(static_cast<unsigned long>(intervalMs));
+	}
+}
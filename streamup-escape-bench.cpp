@@ -0,0 +1,216 @@
+#include "text-escape.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+ * Checks the vectorized TextEscape scan against the scalar reference and
+ * measures both. Every input is scanned from every start offset in every
+ * mode, findSpecial must agree with findSpecialScalar and append must match
+ * a byte-by-byte escape built from the replacement table alone. The inputs
+ * cover random text, random bytes and adversarial layouts such as specials
+ * on 16-byte block edges and a single special in the last byte.
+ *
+ * Exits with 1 on the first mismatch, otherwise prints bytes per second for
+ * the SIMD and scalar paths. --check skips the timing.
+ */
+
+namespace {
+
+using TextEscape::Mode;
+
+constexpr Mode MODES[] = {Mode::Xml, Mode::EdlComment, Mode::TextLine, Mode::Json};
+constexpr const char *MODE_NAMES[] = {"xml", "edl", "text", "json"};
+constexpr size_t BENCH_BYTES = 4 * 1024 * 1024;
+constexpr int BENCH_ROUNDS = 20;
+
+// Results are stored here so the timed loops cannot be optimized away
+volatile size_t benchSink;
+
+struct Input {
+	const char *name;
+	std::string bytes;
+};
+
+// Escapes one byte at a time from the table, independent of either scan
+std::string referenceEscape(const std::string &bytes, Mode mode)
+{
+	std::string out;
+	for (const char c : bytes) {
+		const TextEscape::Replacement &replacement = TextEscape::replacementFor(static_cast<unsigned char>(c), mode);
+		if (replacement.text) {
+			out.append(replacement.text, replacement.length);
+		} else {
+			out.push_back(c);
+		}
+	}
+	return out;
+}
+
+// Mostly clean text, roughly one special per line like real chapter names and annotations
+std::string randomText(std::mt19937 &random, size_t length)
+{
+	static const char specials[] = "&<>\"'|\\\n\t\r";
+	const std::string words = "The quick brown fox jumps over the lazy dog 0123456789 ";
+	std::string text;
+	text.reserve(length);
+	while (text.size() < length) {
+		if (random() % 64 == 0) {
+			text.push_back(specials[random() % (sizeof(specials) - 1)]);
+		} else if (random() % 16 == 0) {
+			text.append("\xC3\xA9\xE2\x82\xAC"); // é and € in UTF-8
+		} else {
+			text.push_back(words[random() % words.size()]);
+		}
+	}
+	text.resize(length);
+	return text;
+}
+
+std::string randomBytes(std::mt19937 &random, size_t length)
+{
+	std::string bytes(length, '\0');
+	for (char &byte : bytes) {
+		byte = static_cast<char>(random() & 0xFF);
+	}
+	return bytes;
+}
+
+std::vector<Input> makeInputs()
+{
+	std::mt19937 random(20261018);
+	std::vector<Input> inputs;
+	inputs.push_back({"empty", std::string()});
+	inputs.push_back({"random text", randomText(random, 4096)});
+	inputs.push_back({"random bytes", randomBytes(random, 4096)});
+	inputs.push_back({"all specials", std::string(257, '&') + std::string(257, '|') + std::string(257, '\\')});
+
+	// Every byte that any mode flags, and the bytes around the control range
+	std::string edges;
+	for (int c = 0; c < 256; ++c) {
+		edges.push_back(static_cast<char>(c));
+	}
+	inputs.push_back({"all byte values", edges});
+
+	// A special just before, on and after each 16-byte block edge
+	for (const size_t position : {size_t(14), size_t(15), size_t(16), size_t(17), size_t(31), size_t(32)}) {
+		std::string clean(48, 'a');
+		clean[position] = '<';
+		inputs.push_back({"block edge", clean});
+	}
+
+	// A long clean run with the only special in the last byte, then one past a whole block
+	std::string last(4095, 'x');
+	last.push_back('"');
+	inputs.push_back({"special in last byte", last});
+	inputs.push_back({"special after blocks", std::string(64, 'x') + '\x1F'});
+
+	// 0x7F and UTF-8 lead bytes sit next to the control range but must never be flagged
+	inputs.push_back({"near control range", std::string(40, '\x20') + std::string(40, '\x7F') + std::string(40, '\xC0')});
+
+	// Short inputs cover every tail length of the vector loop
+	for (size_t length = 1; length <= 40; ++length) {
+		inputs.push_back({"short", randomText(random, length)});
+	}
+	return inputs;
+}
+
+bool checkInput(const Input &input)
+{
+	const std::string &bytes = input.bytes;
+	for (size_t m = 0; m < std::size(MODES); ++m) {
+		const Mode mode = MODES[m];
+		for (size_t offset = 0; offset <= bytes.size(); ++offset) {
+			const size_t simd = TextEscape::findSpecial(bytes.data() + offset, bytes.size() - offset, mode);
+			const size_t scalar = TextEscape::findSpecialScalar(bytes.data() + offset, bytes.size() - offset, mode);
+			if (simd != scalar) {
+				fprintf(stderr, "findSpecial mismatch: %s, mode %s, offset %zu, length %zu: %zu vs %zu\n", input.name,
+					MODE_NAMES[m], offset, bytes.size(), simd, scalar);
+				return false;
+			}
+		}
+
+		std::string escaped;
+		TextEscape::append(escaped, bytes.data(), bytes.size(), mode);
+		if (escaped != referenceEscape(bytes, mode)) {
+			fprintf(stderr, "append mismatch: %s, mode %s, length %zu\n", input.name, MODE_NAMES[m], bytes.size());
+			return false;
+		}
+	}
+	return true;
+}
+
+// Scans the whole buffer special by special the way append does, so both paths do the same work
+template<typename Scan> double bytesPerSecond(const std::string &bytes, Mode mode, Scan scan)
+{
+	size_t found = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; ++round) {
+		size_t position = 0;
+		while (position < bytes.size()) {
+			position += scan(bytes.data() + position, bytes.size() - position, mode) + 1;
+			++found;
+		}
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	benchSink = found;
+	return static_cast<double>(bytes.size()) * BENCH_ROUNDS / elapsed.count();
+}
+
+double appendBytesPerSecond(const std::string &bytes, Mode mode)
+{
+	std::string out;
+	out.reserve(bytes.size() * 2);
+	const auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; ++round) {
+		out.clear();
+		TextEscape::append(out, bytes.data(), bytes.size(), mode);
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	benchSink = out.size();
+	return static_cast<double>(bytes.size()) * BENCH_ROUNDS / elapsed.count();
+}
+
+void benchmark()
+{
+	std::mt19937 random(1);
+	const Input inputs[] = {
+		{"text", randomText(random, BENCH_BYTES)},
+		{"clean", std::string(BENCH_BYTES, 'a')},
+		{"dense", randomBytes(random, BENCH_BYTES)},
+	};
+
+	printf("%-6s %-5s %14s %14s %14s\n", "input", "mode", "simd MB/s", "scalar MB/s", "append MB/s");
+	for (const Input &input : inputs) {
+		for (size_t m = 0; m < std::size(MODES); ++m) {
+			const double simd = bytesPerSecond(input.bytes, MODES[m], TextEscape::findSpecial);
+			const double scalar = bytesPerSecond(input.bytes, MODES[m], TextEscape::findSpecialScalar);
+			const double append = appendBytesPerSecond(input.bytes, MODES[m]);
+			printf("%-6s %-5s %14.0f %14.0f %14.0f\n", input.name, MODE_NAMES[m], simd / 1e6, scalar / 1e6, append / 1e6);
+		}
+	}
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	const bool checkOnly = argc > 1 && strcmp(argv[1], "--check") == 0;
+
+	const std::vector<Input> inputs = makeInputs();
+	for (const Input &input : inputs) {
+		if (!checkInput(input)) {
+			return 1;
+		}
+	}
+	printf("%zu inputs match the scalar reference in every mode\n", inputs.size());
+
+	if (!checkOnly) {
+		benchmark();
+	}
+	return 0;
+}
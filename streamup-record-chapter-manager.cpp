@@ -10,12 +10,17 @@
 #include <obs-module.h>
 #include <obs.h>
 #include <util/platform.h>
+#include <QDateTime>
 #include <QDir>
 #include <QDockWidget>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QMainWindow>
 #include <QTextStream>
+#include <QThread>
+#include <climits>
+#include <cstring>
 
 #define QT_UTF8(str) QString::fromUtf8(str)
 #define QT_TO_UTF8(str) str.toUtf8().constData()
@@ -61,8 +66,13 @@ static void OnStartRecording()
 
 	chapterMarkerDock->createExportFiles();
 
-	QString timestamp = chapterMarkerDock->getCurrentRecordingTime();
-	chapterMarkerDock->addChapterMarker(obs_module_text("Start"), obs_module_text("Recording"));
+	chapterMarkerDock->addChapterMarker(obs_module_text("Start"), MarkerSource::Kind::Recording);
+
+	obs_data_t *event_data = obs_data_create();
+	obs_data_set_int(event_data, "fpsNum", chapterMarkerDock->recordingTimebase.fpsNum);
+	obs_data_set_int(event_data, "fpsDen", chapterMarkerDock->recordingTimebase.fpsDen);
+	EmitChapterEvent("ChapterSessionStarted", event_data);
+	obs_data_release(event_data);
 }
 
 static void FrontEndEventHandler(enum obs_frontend_event event, void *)
@@ -72,6 +82,9 @@ static void FrontEndEventHandler(enum obs_frontend_event event, void *)
 		if (chapterMarkerDock) {
 			chapterMarkerDock->isFirstRunInRecording = true;
 			chapterMarkerDock->resetRecordingStartFrameCount(); // Reset frame count to start at 00:00:00
+			chapterMarkerDock->probeInContainerChapterSupport();
+			chapterMarkerDock->chapterFanout.start();
+			chapterMarkerDock->startSilenceDetection();
 			chapterMarkerDock->updateCurrentChapterLabel(obs_module_text("Start"));
 			OnStartRecording();
 		}
@@ -90,9 +103,73 @@ static void FrontEndEventHandler(enum obs_frontend_event event, void *)
 //--------------------WEBSOCKET HANDLERS--------------------
 obs_websocket_vendor vendor = nullptr;
 
-void EmitWebSocketEvent(const char *event_type, obs_data_t *data)
+struct NativeSignal {
+	const char *eventType;
+	const char *name;
+	const char *declaration; // Parameters are the event's fields, arrays and objects stay WebSocket only
+};
+
+static const NativeSignal NATIVE_SIGNALS[] = {
+	{"ChapterMarkerSet", "streamup_chapter_marker_set",
+	 "void streamup_chapter_marker_set(int markerId, string chapterName, string chapterSource)"},
+	{"ChapterMarkerRenamed", "streamup_chapter_marker_renamed", "void streamup_chapter_marker_renamed(int markerId, string chapterName)"},
+	{"ChapterMarkerDeleted", "streamup_chapter_marker_deleted", "void streamup_chapter_marker_deleted(int markerId)"},
+	{"AnnotationSet", "streamup_chapter_annotation_set",
+	 "void streamup_chapter_annotation_set(string annotationText, string annotationId, string timestamp, string annotationSource)"},
+	{"ChapterSessionStarted", "streamup_chapter_session_started", "void streamup_chapter_session_started(int fpsNum, int fpsDen)"},
+	{"ChapterSessionStopped", "streamup_chapter_session_stopped",
+	 "void streamup_chapter_session_stopped(string recordingPath, int chapterCount)"},
+	{"ChapterFilesFinalized", "streamup_chapter_files_finalized", "void streamup_chapter_files_finalized(bool success, int durationMs)"},
+};
+
+static void EmitNativeSignal(const char *event_type, obs_data_t *data)
+{
+	const NativeSignal *found = nullptr;
+	for (const NativeSignal &nativeSignal : NATIVE_SIGNALS) {
+		if (strcmp(nativeSignal.eventType, event_type) == 0) {
+			found = &nativeSignal;
+			break;
+		}
+	}
+	if (!found) {
+		return;
+	}
+
+	calldata_t cd;
+	calldata_init(&cd);
+	for (obs_data_item_t *item = obs_data_first(data); item; obs_data_item_next(&item)) {
+		const char *name = obs_data_item_get_name(item);
+		switch (obs_data_item_gettype(item)) {
+		case OBS_DATA_STRING:
+			calldata_set_string(&cd, name, obs_data_item_get_string(item));
+			break;
+		case OBS_DATA_NUMBER:
+			if (obs_data_item_numtype(item) == OBS_DATA_NUM_DOUBLE) {
+				calldata_set_float(&cd, name, obs_data_item_get_double(item));
+			} else {
+				calldata_set_int(&cd, name, obs_data_item_get_int(item));
+			}
+			break;
+		case OBS_DATA_BOOLEAN:
+			calldata_set_bool(&cd, name, obs_data_item_get_bool(item));
+			break;
+		default:
+			break;
+		}
+	}
+	signal_handler_signal(obs_get_signal_handler(), found->name, &cd);
+	calldata_free(&cd);
+}
+
+void EmitChapterEvent(const char *event_type, obs_data_t *data)
 {
 	obs_websocket_vendor_emit_event(vendor, event_type, data);
+	EmitNativeSignal(event_type, data);
+	if (chapterMarkerDock) {
+		const char *eventJson = obs_data_get_json(data);
+		chapterMarkerDock->webhookSender.post(event_type, eventJson);
+		chapterMarkerDock->eventFeed.post(event_type, eventJson);
+	}
 }
 
 void WebsocketRequestSetChapterMarker(obs_data_t *request_data, obs_data_t *response_data, void *)
@@ -113,16 +190,8 @@ void WebsocketRequestSetChapterMarker(obs_data_t *request_data, obs_data_t *resp
 	QString qChapterName = QString::fromUtf8(chapterName ? chapterName : "");
 	QString qChapterSource = QString::fromUtf8(chapterSource ? chapterSource : "");
 
-	// If chapterName is empty, use the default chapter name logic
-	if (qChapterName.isEmpty()) {
-		qChapterName = chapterMarkerDock->defaultChapterName + " " + QString::number(chapterMarkerDock->chapterCount);
-		chapterMarkerDock->chapterCount++;
-	}
-
-	// If chapterSource is empty, default to "WebSocket"
-	if (qChapterSource.isEmpty()) {
-		qChapterSource = obs_module_text("WebSocket");
-	}
+	// An empty chapterName is filled with the default chapter name template on the UI thread,
+	// the source is mapped to its kind there too and an empty one counts as WebSocket
 
 	// Emit the signal to add the chapter marker
 	if (chapterMarkerDock) {
@@ -195,11 +264,6 @@ void WebsocketRequestSetAnnotation(obs_data_t *request_data, obs_data_t *respons
 		return;
 	}
 
-	// If annotationSource is empty, default to "WebSocket"
-	if (qAnnotationSource.isEmpty()) {
-		qAnnotationSource = obs_module_text("WebSocket");
-	}
-
 	// Emit the signal to add the annotation
 	if (chapterMarkerDock) {
 
@@ -213,6 +277,274 @@ void WebsocketRequestSetAnnotation(obs_data_t *request_data, obs_data_t *respons
 	}
 }
 
+void WebsocketRequestGetAnnotation(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	// Exports only carry the annotation id, clients fetch the full text with it
+	const char *annotationId = obs_data_get_string(request_data, "annotationId");
+	const QString qAnnotationId = QString::fromUtf8(annotationId ? annotationId : "").trimmed().remove(QChar('#')).toLower();
+
+	if (!chapterMarkerDock) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerNotOpen"));
+		return;
+	}
+
+	QString annotationText;
+	if (qAnnotationId.isEmpty() || !chapterMarkerDock->annotationStore.body(qAnnotationId, annotationText)) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "message", obs_module_text("AnnotationNotFound"));
+		return;
+	}
+
+	obs_data_set_bool(response_data, "success", true);
+	obs_data_set_string(response_data, "annotationId", QT_TO_UTF8(qAnnotationId));
+	obs_data_set_string(response_data, "annotationText", QT_TO_UTF8(annotationText));
+}
+
+void WebsocketRequestSearchRecordings(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	const char *query = obs_data_get_string(request_data, "query");
+	obs_data_set_default_int(request_data, "limit", SessionCatalog::DEFAULT_RESULT_LIMIT);
+	const int limit = static_cast<int>(obs_data_get_int(request_data, "limit"));
+
+	if (!chapterMarkerDock) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerNotOpen"));
+		return;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	const QVector<SessionCatalog::Match> matches = chapterMarkerDock->sessionCatalog.search(QString::fromUtf8(query ? query : ""), limit);
+	const qint64 elapsedNs = timer.nsecsElapsed();
+
+	obs_data_array_t *results = obs_data_array_create();
+	char timestamp[Timecode::BUFFER_SIZE];
+	for (const SessionCatalog::Match &match : matches) {
+		Timecode::formatHms(timestamp, match.entry.frameOffset, match.timebase);
+		const QString recordedAt = QDateTime::fromMSecsSinceEpoch(match.recordedAtMs).toString(Qt::ISODate);
+
+		obs_data_t *result = obs_data_create();
+		obs_data_set_string(result, "recordingPath", QT_TO_UTF8(match.recordingPath));
+		obs_data_set_string(result, "recordedAt", QT_TO_UTF8(recordedAt));
+		obs_data_set_string(result, "timestamp", timestamp);
+		obs_data_set_string(result, "text", QT_TO_UTF8(match.entry.text));
+		obs_data_set_string(result, "source", QT_TO_UTF8(match.entry.source));
+		obs_data_set_bool(result, "annotation", match.entry.annotation);
+		obs_data_array_push_back(results, result);
+		obs_data_release(result);
+	}
+
+	obs_data_set_bool(response_data, "success", true);
+	obs_data_set_array(response_data, "results", results);
+	obs_data_set_int(response_data, "sessionCount", chapterMarkerDock->sessionCatalog.sessionCount());
+	obs_data_set_double(response_data, "durationMs", static_cast<double>(elapsedNs) / 1000000.0);
+	obs_data_array_release(results);
+}
+
+// Chapter edits run on the UI thread like new markers, the response only confirms the request was queued
+static bool CheckChapterEditRequest(obs_data_t *response_data)
+{
+	if (!obs_frontend_recording_active()) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerNotActive"));
+		return false;
+	}
+	if (!chapterMarkerDock) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerNotOpen"));
+		return false;
+	}
+	return true;
+}
+
+// Rejects ids the UI thread would drop anyway, so clients get an answer they can act on
+static bool CheckChapterEditTarget(obs_data_t *request_data, obs_data_t *response_data, int &markerId)
+{
+	const long long requestedId = obs_data_get_int(request_data, "markerId");
+	if (requestedId < 0 || requestedId > INT_MAX || !chapterMarkerDock->isPublishedChapterLive(static_cast<int>(requestedId))) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerEditFailed"));
+		return false;
+	}
+	markerId = static_cast<int>(requestedId);
+	return true;
+}
+
+void WebsocketRequestRenameChapterMarker(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	if (!CheckChapterEditRequest(response_data)) {
+		return;
+	}
+
+	int markerId = -1;
+	if (!CheckChapterEditTarget(request_data, response_data, markerId)) {
+		return;
+	}
+
+	const char *chapterName = obs_data_get_string(request_data, "chapterName");
+	const QString qChapterName = QString::fromUtf8(chapterName ? chapterName : "");
+	if (qChapterName.trimmed().isEmpty()) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerNameIsEmpty"));
+		return;
+	}
+
+	emit chapterMarkerDock->renameChapterMarkerSignal(markerId, qChapterName);
+
+	obs_data_set_bool(response_data, "success", true);
+	obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerEditQueued"));
+}
+
+void WebsocketRequestDeleteChapterMarker(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	if (!CheckChapterEditRequest(response_data)) {
+		return;
+	}
+
+	int markerId = -1;
+	if (!CheckChapterEditTarget(request_data, response_data, markerId)) {
+		return;
+	}
+
+	emit chapterMarkerDock->deleteChapterMarkerSignal(markerId);
+
+	obs_data_set_bool(response_data, "success", true);
+	obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerEditQueued"));
+}
+
+void WebsocketRequestUndoLastChapterMarker(obs_data_t *request_data, obs_data_t *response_data, void *)
+{
+	UNUSED_PARAMETER(request_data);
+
+	if (!CheckChapterEditRequest(response_data)) {
+		return;
+	}
+
+	if (!chapterMarkerDock->hasPublishedLiveChapter()) {
+		obs_data_set_bool(response_data, "success", false);
+		obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerNothingToUndo"));
+		return;
+	}
+
+	emit chapterMarkerDock->undoLastChapterMarkerSignal();
+
+	obs_data_set_bool(response_data, "success", true);
+	obs_data_set_string(response_data, "message", obs_module_text("ChapterMarkerEditQueued"));
+}
+
+//--------------------PROC HANDLERS--------------------
+// Native entry points for scripts and other plugins, no JSON or socket in between. Calls made on the UI thread
+// add the marker straight away like a hotkey, calls from other threads are queued to it like WebSocket requests.
+static bool OnDockThread()
+{
+	return QThread::currentThread() == chapterMarkerDock->thread();
+}
+
+static void ProcAddChapterMarker(void *, calldata_t *cd)
+{
+	if (!chapterMarkerDock || !obs_frontend_recording_active()) {
+		calldata_set_bool(cd, "success", false);
+		return;
+	}
+
+	const char *chapterName = calldata_string(cd, "chapter_name");
+	const char *chapterSource = calldata_string(cd, "chapter_source");
+	const QString qChapterName = QString::fromUtf8(chapterName ? chapterName : "");
+	const QString qChapterSource = chapterSource && *chapterSource ? QString::fromUtf8(chapterSource)
+								      : QString::fromLatin1(MarkerSource::info(MarkerSource::Kind::Script).webSocketName);
+
+	if (OnDockThread()) {
+		chapterMarkerDock->onAddChapterMarker(qChapterName, qChapterSource);
+	} else {
+		emit chapterMarkerDock->addChapterMarkerSignal(qChapterName, qChapterSource);
+	}
+	calldata_set_bool(cd, "success", true);
+}
+
+static void ProcAddAnnotation(void *, calldata_t *cd)
+{
+	const char *annotationText = calldata_string(cd, "annotation_text");
+	if (!chapterMarkerDock || !obs_frontend_recording_active() || !annotationText || !*annotationText) {
+		calldata_set_bool(cd, "success", false);
+		return;
+	}
+
+	const char *annotationSource = calldata_string(cd, "annotation_source");
+	const QString qAnnotationText = QString::fromUtf8(annotationText);
+	const QString qAnnotationSource = annotationSource && *annotationSource
+						  ? QString::fromUtf8(annotationSource)
+						  : QString::fromLatin1(MarkerSource::info(MarkerSource::Kind::Script).webSocketName);
+
+	if (OnDockThread()) {
+		chapterMarkerDock->onAddAnnotation(qAnnotationText, qAnnotationSource);
+	} else {
+		emit chapterMarkerDock->addAnnotationSignal(qAnnotationText, qAnnotationSource);
+	}
+	calldata_set_bool(cd, "success", true);
+}
+
+static void ProcGetCurrentChapterMarker(void *, calldata_t *cd)
+{
+	const QVector<PublishedChapter> chapters = chapterMarkerDock ? chapterMarkerDock->publishedChapters() : QVector<PublishedChapter>();
+	for (auto it = chapters.crbegin(); it != chapters.crend(); ++it) {
+		if (!it->deleted) {
+			calldata_set_string(cd, "chapter_name", QT_TO_UTF8(it->chapterName));
+			calldata_set_int(cd, "marker_id", it->markerId);
+			calldata_set_int(cd, "time_ms", it->timeMs);
+			calldata_set_bool(cd, "success", true);
+			return;
+		}
+	}
+	calldata_set_bool(cd, "success", false);
+}
+
+static void ProcGetChapterHistory(void *, calldata_t *cd)
+{
+	if (!chapterMarkerDock) {
+		calldata_set_bool(cd, "success", false);
+		return;
+	}
+
+	// Scripts get JSON, calldata has no array type
+	obs_data_array_t *chaptersArray = obs_data_array_create();
+	int count = 0;
+	for (const PublishedChapter &chapter : chapterMarkerDock->publishedChapters()) {
+		if (chapter.deleted) {
+			continue;
+		}
+		obs_data_t *chapterData = obs_data_create();
+		obs_data_set_int(chapterData, "markerId", chapter.markerId);
+		obs_data_set_int(chapterData, "timeMs", chapter.timeMs);
+		obs_data_set_string(chapterData, "chapterName", QT_TO_UTF8(chapter.chapterName));
+		obs_data_array_push_back(chaptersArray, chapterData);
+		obs_data_release(chapterData);
+		++count;
+	}
+
+	obs_data_t *history = obs_data_create();
+	obs_data_set_array(history, "chapters", chaptersArray);
+	calldata_set_string(cd, "chapters_json", obs_data_get_json(history));
+	calldata_set_int(cd, "count", count);
+	calldata_set_bool(cd, "success", true);
+	obs_data_release(history);
+	obs_data_array_release(chaptersArray);
+}
+
+static void RegisterProcHandlers()
+{
+	proc_handler_t *ph = obs_get_proc_handler();
+	proc_handler_add(ph, Constants::PROC_ADD_CHAPTER, ProcAddChapterMarker, nullptr);
+	proc_handler_add(ph, Constants::PROC_ADD_ANNOTATION, ProcAddAnnotation, nullptr);
+	proc_handler_add(ph, Constants::PROC_GET_CURRENT_CHAPTER, ProcGetCurrentChapterMarker, nullptr);
+	proc_handler_add(ph, Constants::PROC_GET_CHAPTER_HISTORY, ProcGetChapterHistory, nullptr);
+
+	signal_handler_t *sh = obs_get_signal_handler();
+	for (const NativeSignal &nativeSignal : NATIVE_SIGNALS) {
+		signal_handler_add(sh, nativeSignal.declaration);
+	}
+}
+
 //--------------------HOTKEY HANDLERS--------------------
 obs_hotkey_id addDefaultChapterMarkerHotkey = OBS_INVALID_HOTKEY_ID;
 
@@ -272,11 +604,8 @@ void AddDefaultChapterMarkerHotkey(void *data, obs_hotkey_id id, obs_hotkey_t *h
 		return;
 	}
 
-	QString chapterName = chapterMarkerDock->defaultChapterName + " " + QString::number(chapterMarkerDock->chapterCount);
-	chapterMarkerDock->addChapterMarker(chapterName, obs_module_text("Hotkey"));
+	chapterMarkerDock->addChapterMarker(chapterMarkerDock->formatDefaultChapterName(true), MarkerSource::Kind::Hotkey);
 	blog(LOG_INFO, "[StreamUP Record Chapter Manager] chapterCount: %d", chapterMarkerDock->chapterCount);
-
-	chapterMarkerDock->chapterCount++; // Increment the chapter count
 }
 
 void AddChapterMarkerHotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
@@ -300,7 +629,7 @@ void AddChapterMarkerHotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey,
 	}
 
 	if (!chapterName.isEmpty()) {
-		chapterMarkerDock->addChapterMarker(chapterName, obs_module_text("PresetHotkey"));
+		chapterMarkerDock->addChapterMarker(chapterName, MarkerSource::Kind::PresetHotkey);
 		blog(LOG_INFO, "[StreamUP Record Chapter Manager] Added chapter marker for: %s", QT_TO_UTF8(chapterName));
 	}
 }
@@ -378,6 +707,21 @@ static void RegisterWebsocketRequests()
 
 	obs_websocket_vendor_register_request(vendor, Constants::WS_REQUEST_SET_ANNOTATION, WebsocketRequestSetAnnotation,
 					      nullptr);
+
+	obs_websocket_vendor_register_request(vendor, Constants::WS_REQUEST_GET_ANNOTATION, WebsocketRequestGetAnnotation,
+					      nullptr);
+
+	obs_websocket_vendor_register_request(vendor, Constants::WS_REQUEST_RENAME_CHAPTER, WebsocketRequestRenameChapterMarker,
+					      nullptr);
+
+	obs_websocket_vendor_register_request(vendor, Constants::WS_REQUEST_DELETE_CHAPTER, WebsocketRequestDeleteChapterMarker,
+					      nullptr);
+
+	obs_websocket_vendor_register_request(vendor, Constants::WS_REQUEST_UNDO_CHAPTER, WebsocketRequestUndoLastChapterMarker,
+					      nullptr);
+
+	obs_websocket_vendor_register_request(vendor, Constants::WS_REQUEST_SEARCH_RECORDINGS, WebsocketRequestSearchRecordings,
+					      nullptr);
 }
 
 bool (*obs_frontend_recording_add_chapter_wrapper)(const char *name) = nullptr;
@@ -390,8 +734,11 @@ bool obs_module_load()
 	obs_frontend_recording_add_chapter_wrapper =
 		(bool (*)(const char *name))os_dlsym(handle, "obs_frontend_recording_add_chapter");
 
+	MarkerSource::loadLabels();
+
 	RegisterHotkeys();
 	RegisterWebsocketRequests();
+	RegisterProcHandlers();
 
 	obs_frontend_add_save_callback(SaveLoadHotkeys, nullptr);
 	obs_frontend_add_event_callback(FrontEndEventHandler, nullptr);
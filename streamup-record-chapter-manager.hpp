@@ -19,8 +19,8 @@ obs_data_t *SaveLoadSettingsCallback(obs_data_t *save_data, bool saving);
 QString GetCurrentChapterName();
 extern QString currentChapterName;
 
-// WebSocket integration
-void EmitWebSocketEvent(const char *event_type, obs_data_t *data);
+// Sent as a WebSocket vendor event, to the webhooks and, for the events in the signal table, as a native signal
+void EmitChapterEvent(const char *event_type, obs_data_t *data);
 
 // Hotkey callbacks
 void AddDefaultChapterMarkerHotkey(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
@@ -0,0 +1,49 @@
+#include "string-arena.hpp"
+#include <cstring>
+
+StringArena::Id StringArena::intern(const QString &text)
+{
+	const auto existing = lookup.constFind(text);
+	if (existing != lookup.constEnd()) {
+		return existing.value();
+	}
+
+	const QByteArray utf8 = text.toUtf8();
+	char *stored = allocate(static_cast<size_t>(utf8.size()) + 1);
+	memcpy(stored, utf8.constData(), static_cast<size_t>(utf8.size()) + 1);
+
+	const Id id = static_cast<Id>(entries.size());
+	entries.append({stored, static_cast<uint32_t>(utf8.size()), text});
+	// The key shares its data with the entry
+	lookup.insert(entries.last().text, id);
+	return id;
+}
+
+char *StringArena::allocate(size_t size)
+{
+	usedBytes += size;
+
+	// Oversized strings get a block of their own so the current block keeps its space
+	if (size > BLOCK_SIZE / 4) {
+		largeBlocks.push_back(std::make_unique<char[]>(size));
+		return largeBlocks.back().get();
+	}
+
+	if (blockUsed + size > BLOCK_SIZE) {
+		blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+		blockUsed = 0;
+	}
+	char *out = blocks.back().get() + blockUsed;
+	blockUsed += size;
+	return out;
+}
+
+void StringArena::clear()
+{
+	lookup.clear();
+	entries.clear();
+	blocks.clear();
+	largeBlocks.clear();
+	blockUsed = BLOCK_SIZE;
+	usedBytes = 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#ifndef STRING_ARENA_HPP
+#define STRING_ARENA_HPP
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class StringArena
+ * @brief Interning table for the names and sources used during one recording
+ *
+ * Every distinct string is stored once as NUL-terminated UTF-8 in large arena
+ * blocks, next to a QString built once on interning. Callers keep the small Id
+ * and read either form back without converting again. clear() drops every
+ * block in one step, ids are only valid until then.
+ */
+class StringArena {
+public:
+	using Id = uint32_t;
+	static constexpr Id INVALID_ID = UINT32_MAX;
+
+	Id intern(const QString &text);
+
+	const QString &text(Id id) const { return entries[id].text; }
+	const char *utf8(Id id) const { return entries[id].utf8; }
+	int utf8Length(Id id) const { return static_cast<int>(entries[id].length); }
+
+	int count() const { return static_cast<int>(entries.size()); }
+	size_t bytesUsed() const { return usedBytes; }
+	void clear();
+
+private:
+	struct Entry {
+		const char *utf8;
+		uint32_t length;
+		QString text;
+	};
+
+	static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+	char *allocate(size_t size);
+
+	std::vector<std::unique_ptr<char[]>> blocks;
+	std::vector<std::unique_ptr<char[]>> largeBlocks;
+	size_t blockUsed = BLOCK_SIZE;
+	size_t usedBytes = 0;
+	QVector<Entry> entries;
+	QHash<QString, Id> lookup;
+};
+
+#endif // STRING_ARENA_HPP
@@ -0,0 +1,182 @@
+#include "text-escape.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXT_ESCAPE_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define TEXT_ESCAPE_NEON
+#endif
+
+#if defined(_MSC_VER) && defined(TEXT_ESCAPE_SSE2)
+#include <intrin.h>
+#endif
+
+namespace TextEscape {
+
+namespace {
+
+constexpr unsigned char CONTROL_MAX = 0x1F;
+constexpr size_t MODE_COUNT = static_cast<size_t>(Mode::ModeCount);
+
+constexpr const char *JSON_CONTROL_ESCAPES[CONTROL_MAX + 1] = {
+	"\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+	"\\b",     "\\t",     "\\n",     "\\u000b", "\\f",     "\\r",     "\\u000e", "\\u000f",
+	"\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+	"\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d", "\\u001e", "\\u001f"};
+
+// Every byte flagged here is a candidate for the SIMD scan; a nullptr replacement keeps the byte
+struct ModeTable {
+	bool special[256];
+	Replacement replacements[256];
+};
+
+constexpr ModeTable makeTable(Mode mode)
+{
+	ModeTable table{};
+	for (int c = 0; c <= CONTROL_MAX; ++c) {
+		table.special[c] = true;
+		table.replacements[c] = {"", 0};
+	}
+
+	switch (mode) {
+	case Mode::Xml:
+		table.replacements['\t'] = {nullptr, 0};
+		table.replacements['\n'] = {nullptr, 0};
+		table.replacements['\r'] = {nullptr, 0};
+		table.special['&'] = true;
+		table.replacements['&'] = {"&amp;", 5};
+		table.special['<'] = true;
+		table.replacements['<'] = {"&lt;", 4};
+		table.special['>'] = true;
+		table.replacements['>'] = {"&gt;", 4};
+		table.special['"'] = true;
+		table.replacements['"'] = {"&quot;", 6};
+		table.special['\''] = true;
+		table.replacements['\''] = {"&apos;", 6};
+		break;
+	case Mode::EdlComment:
+		table.replacements['\t'] = {" ", 1};
+		table.replacements['\n'] = {" ", 1};
+		table.replacements['\r'] = {" ", 1};
+		table.special['|'] = true;
+		table.replacements['|'] = {"/", 1};
+		break;
+	case Mode::Json:
+		for (int c = 0; c <= CONTROL_MAX; ++c) {
+			const char *escape = JSON_CONTROL_ESCAPES[c];
+			table.replacements[c] = {escape, static_cast<unsigned char>(escape[1] == 'u' ? 6 : 2)};
+		}
+		table.special['"'] = true;
+		table.replacements['"'] = {"\\\"", 2};
+		table.special['\\'] = true;
+		table.replacements['\\'] = {"\\\\", 2};
+		break;
+	case Mode::TextLine:
+	case Mode::ModeCount:
+		table.replacements['\t'] = {nullptr, 0};
+		table.replacements['\n'] = {" ", 1};
+		table.replacements['\r'] = {" ", 1};
+		break;
+	}
+	return table;
+}
+
+constexpr ModeTable TABLES[MODE_COUNT] = {makeTable(Mode::Xml), makeTable(Mode::EdlComment), makeTable(Mode::TextLine),
+					  makeTable(Mode::Json)};
+
+// Printable bytes each mode flags on top of the control range, these drive the SIMD compares
+struct ModeChars {
+	char chars[5];
+	int count;
+};
+
+constexpr ModeChars MODE_CHARS[MODE_COUNT] = {
+	{{'&', '<', '>', '"', '\''}, 5},
+	{{'|'}, 1},
+	{{}, 0},
+	{{'"', '\\'}, 2},
+};
+
+#ifdef TEXT_ESCAPE_SSE2
+inline int firstSetBit(int mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, static_cast<unsigned long>(mask));
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(static_cast<unsigned int>(mask));
+#endif
+}
+#endif
+
+} // namespace
+
+const Replacement &replacementFor(unsigned char c, Mode mode)
+{
+	return TABLES[static_cast<size_t>(mode)].replacements[c];
+}
+
+size_t findSpecialScalar(const char *data, size_t length, Mode mode)
+{
+	const bool *special = TABLES[static_cast<size_t>(mode)].special;
+	for (size_t i = 0; i < length; ++i) {
+		if (special[static_cast<unsigned char>(data[i])]) {
+			return i;
+		}
+	}
+	return length;
+}
+
+size_t findSpecial(const char *data, size_t length, Mode mode)
+{
+	size_t i = 0;
+
+#if defined(TEXT_ESCAPE_SSE2)
+	const ModeChars &modeChars = MODE_CHARS[static_cast<size_t>(mode)];
+	__m128i splats[5];
+	for (int c = 0; c < modeChars.count; ++c) {
+		splats[c] = _mm_set1_epi8(modeChars.chars[c]);
+	}
+	const __m128i controlMax = _mm_set1_epi8(static_cast<char>(CONTROL_MAX));
+
+	for (; i + 16 <= length; i += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+		// Unsigned bytes <= 0x1F, UTF-8 lead and continuation bytes are left alone
+		__m128i hits = _mm_cmpeq_epi8(_mm_min_epu8(bytes, controlMax), bytes);
+		for (int c = 0; c < modeChars.count; ++c) {
+			hits = _mm_or_si128(hits, _mm_cmpeq_epi8(bytes, splats[c]));
+		}
+
+		const int mask = _mm_movemask_epi8(hits);
+		if (mask != 0) {
+			return i + firstSetBit(mask);
+		}
+	}
+#elif defined(TEXT_ESCAPE_NEON)
+	const ModeChars &modeChars = MODE_CHARS[static_cast<size_t>(mode)];
+	uint8x16_t splats[5];
+	for (int c = 0; c < modeChars.count; ++c) {
+		splats[c] = vdupq_n_u8(static_cast<uint8_t>(modeChars.chars[c]));
+	}
+	const uint8x16_t controlMax = vdupq_n_u8(CONTROL_MAX);
+
+	for (; i + 16 <= length; i += 16) {
+		const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(data + i));
+		uint8x16_t hits = vcleq_u8(bytes, controlMax);
+		for (int c = 0; c < modeChars.count; ++c) {
+			hits = vorrq_u8(hits, vceqq_u8(bytes, splats[c]));
+		}
+
+		// The block has a hit, the scalar scan finds its position
+		if (vmaxvq_u8(hits) != 0) {
+			return i + findSpecialScalar(data + i, 16, mode);
+		}
+	}
+#endif
+
+	return i + findSpecialScalar(data + i, length - i, mode);
+}
+
+} // namespace TextEscape
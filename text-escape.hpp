@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef TEXT_ESCAPE_HPP
+#define TEXT_ESCAPE_HPP
+
+#include <cstddef>
+
+/**
+ * @namespace TextEscape
+ * @brief Escaping for the sidecar formats, working on UTF-8 bytes
+ *
+ * findSpecial() scans 16 bytes at a time (SSE2 or NEON where available) for
+ * the first byte that may need escaping, so clean runs are appended in bulk
+ * and only the flagged bytes go through the replacement table.
+ */
+namespace TextEscape {
+
+enum class Mode {
+	Xml, // Element text and attribute values
+	EdlComment, // Single-line EDL comment, '|' is the Resolve field separator
+	TextLine, // One line of the plain text sidecar
+	Json, // Inside a JSON string, control characters become escapes
+	ModeCount
+};
+
+struct Replacement {
+	const char *text; // nullptr keeps the byte as it is
+	unsigned char length;
+};
+
+// Index of the first byte that may need escaping, or length if there is none
+size_t findSpecial(const char *data, size_t length, Mode mode);
+
+// Scalar reference for findSpecial, also used for the tail of the SIMD scan
+size_t findSpecialScalar(const char *data, size_t length, Mode mode);
+
+const Replacement &replacementFor(unsigned char c, Mode mode);
+
+// Out is any byte container with append(const char *, size) such as QByteArray or std::string
+template<typename Out> void append(Out &out, const char *data, size_t length, Mode mode)
+{
+	size_t position = 0;
+	while (position < length) {
+		const size_t special = position + findSpecial(data + position, length - position, mode);
+		if (special > position) {
+			out.append(data + position, special - position);
+		}
+		if (special >= length) {
+			break;
+		}
+
+		const Replacement &replacement = replacementFor(static_cast<unsigned char>(data[special]), mode);
+		if (replacement.text) {
+			out.append(replacement.text, replacement.length);
+		} else {
+			out.append(data + special, 1);
+		}
+		position = special + 1;
+	}
+}
+
+} // namespace TextEscape
+
+#endif // TEXT_ESCAPE_HPP
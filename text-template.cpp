@@ -0,0 +1,195 @@
+#include "text-template.hpp"
+#include "text-escape.hpp"
+
+//--------------------COMPILE--------------------
+bool TextTemplate::compile(const QString &source, const QStringList &fieldNames, Escape defaultEscape)
+{
+	literals.clear();
+	utf8Literals.clear();
+	ops.clear();
+	error.clear();
+
+	const int length = source.size();
+	int i = 0;
+	while (i < length) {
+		const QChar c = source.at(i);
+
+		// Doubled braces are literal braces
+		if ((c == '{' || c == '}') && i + 1 < length && source.at(i + 1) == c) {
+			appendLiteral(QString(c));
+			i += 2;
+			continue;
+		}
+
+		if (c != '{') {
+			int end = i;
+			while (end < length && source.at(end) != '{' && source.at(end) != '}') {
+				++end;
+			}
+			// A lone closing brace is kept as text
+			if (end == i) {
+				++end;
+			}
+			appendLiteral(source.mid(i, end - i));
+			i = end;
+			continue;
+		}
+
+		const int close = source.indexOf('}', i + 1);
+		if (close < 0) {
+			error = QString("Unclosed placeholder at position %1").arg(i);
+			appendLiteral(source.mid(i));
+			break;
+		}
+
+		const QString placeholder = source.mid(i + 1, close - i - 1);
+		const int separator = placeholder.indexOf(':');
+		const QString fieldName = separator < 0 ? placeholder : placeholder.left(separator);
+		const int field = fieldNames.indexOf(fieldName.trimmed());
+
+		if (field < 0) {
+			error = QString("Unknown placeholder {%1}").arg(placeholder);
+			appendLiteral(source.mid(i, close - i + 1));
+		} else {
+			const Escape escape = separator < 0 ? defaultEscape
+							    : escapeFromName(placeholder.mid(separator + 1).trimmed(), defaultEscape);
+			ops.append({field, 0, 0, 0, 0, escape});
+		}
+		i = close + 1;
+	}
+
+	return error.isEmpty();
+}
+
+void TextTemplate::appendLiteral(const QString &text)
+{
+	if (text.isEmpty()) {
+		return;
+	}
+
+	// Merge neighbouring literal runs so render copies them in one go
+	const QByteArray utf8 = text.toUtf8();
+	if (!ops.isEmpty() && ops.last().field < 0) {
+		ops.last().length += text.size();
+		ops.last().utf8Length += utf8.size();
+	} else {
+		ops.append({-1, static_cast<int>(literals.size()), static_cast<int>(text.size()), static_cast<int>(utf8Literals.size()),
+			    static_cast<int>(utf8.size()), Escape::None});
+	}
+	literals += text;
+	utf8Literals += utf8;
+}
+
+bool TextTemplate::usesField(int field) const
+{
+	for (const Op &op : ops) {
+		if (op.field == field) {
+			return true;
+		}
+	}
+	return false;
+}
+
+TextTemplate::Escape TextTemplate::escapeFromName(const QString &name, Escape fallback)
+{
+	if (name.compare("xml", Qt::CaseInsensitive) == 0) {
+		return Escape::Xml;
+	}
+	if (name.compare("json", Qt::CaseInsensitive) == 0) {
+		return Escape::Json;
+	}
+	if (name.compare("none", Qt::CaseInsensitive) == 0) {
+		return Escape::None;
+	}
+	return fallback;
+}
+
+//--------------------RENDER--------------------
+namespace {
+
+void appendField(QByteArray &out, const QString &value, TextTemplate::Escape escape)
+{
+	const QByteArray utf8 = value.toUtf8();
+	if (escape == TextTemplate::Escape::None) {
+		out += utf8;
+		return;
+	}
+
+	const TextEscape::Mode mode = escape == TextTemplate::Escape::Xml ? TextEscape::Mode::Xml : TextEscape::Mode::Json;
+	TextEscape::append(out, utf8.constData(), static_cast<size_t>(utf8.size()), mode);
+}
+
+} // namespace
+
+void TextTemplate::render(QByteArray &out, const QString *fieldValues) const
+{
+	for (const Op &op : ops) {
+		if (op.field < 0) {
+			out.append(utf8Literals.constData() + op.utf8Offset, op.utf8Length);
+		} else {
+			appendField(out, fieldValues[op.field], op.escape);
+		}
+	}
+}
+
+void TextTemplate::render(QString &out, const QString *fieldValues) const
+{
+	for (const Op &op : ops) {
+		if (op.field < 0) {
+			out.append(literals.constData() + op.offset, op.length);
+		} else if (op.escape == Escape::None) {
+			out += fieldValues[op.field];
+		} else {
+			QByteArray escaped;
+			appendField(escaped, fieldValues[op.field], op.escape);
+			out += QString::fromUtf8(escaped);
+		}
+	}
+}
+
+//--------------------EXPORT TEMPLATE--------------------
+const QStringList &ExportTemplate::fieldNames()
+{
+	// Order matches the Field enum
+	static const QStringList names = {"time", "frame", "timecode", "name", "source", "index", "ref"};
+	return names;
+}
+
+bool ExportTemplate::compile()
+{
+	const TextTemplate::Escape escape = TextTemplate::escapeFromName(escapeName, TextTemplate::Escape::None);
+
+	bool ok = header.compile(headerSource, fieldNames(), escape);
+	ok = marker.compile(markerSource, fieldNames(), escape) && ok;
+	ok = annotation.compile(annotationSource, fieldNames(), escape) && ok;
+	ok = footer.compile(footerSource, fieldNames(), escape) && ok;
+	return ok;
+}
+
+QString ExportTemplate::errorString() const
+{
+	for (const TextTemplate *part : {&header, &marker, &annotation, &footer}) {
+		if (!part->errorString().isEmpty()) {
+			return part->errorString();
+		}
+	}
+	return QString();
+}
+
+bool ExportTemplate::isValidFileSuffix(const QString &suffix)
+{
+	return !suffix.contains('/') && !suffix.contains('\\') && !suffix.contains("..");
+}
+
+bool ExportTemplate::usesField(int field) const
+{
+	return header.usesField(field) || marker.usesField(field) || annotation.usesField(field) || footer.usesField(field);
+}
+
+//--------------------CHAPTER NAME TEMPLATE--------------------
+const QStringList &ChapterNameTemplate::fieldNames()
+{
+	// Order matches the Field enum
+	static const QStringList names = {"name", "count", "scene", "time", "date"};
+	return names;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#ifndef TEXT_TEMPLATE_HPP
+#define TEXT_TEMPLATE_HPP
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @class TextTemplate
+ * @brief Placeholder template compiled once into a flat list of ops
+ *
+ * Placeholders are written as {field} or {field:escape}, where escape is one of
+ * none, xml or json. {{ and }} produce literal braces. Rendering walks the op
+ * list and appends to a caller-owned buffer, so nothing is parsed per render.
+ * Escaped fields go through TextEscape, the same escaping the built-in formats use.
+ */
+class TextTemplate {
+public:
+	enum class Escape { None, Xml, Json };
+
+	bool compile(const QString &source, const QStringList &fieldNames, Escape defaultEscape = Escape::None);
+	// UTF-8 for files, literals are kept encoded so only the fields are converted
+	void render(QByteArray &out, const QString *fieldValues) const;
+	void render(QString &out, const QString *fieldValues) const;
+
+	bool isEmpty() const { return ops.isEmpty(); }
+	bool usesField(int field) const;
+	const QString &errorString() const { return error; }
+
+	static Escape escapeFromName(const QString &name, Escape fallback);
+
+private:
+	struct Op {
+		int field; // -1 for literal text
+		int offset;
+		int length;
+		int utf8Offset;
+		int utf8Length;
+		Escape escape;
+	};
+
+	void appendLiteral(const QString &text);
+
+	QString literals;
+	QByteArray utf8Literals;
+	QVector<Op> ops;
+	QString error;
+};
+
+/**
+ * @struct ExportTemplate
+ * @brief User-defined sidecar layout built from four templates sharing the marker fields
+ */
+struct ExportTemplate {
+	enum Field { FieldTime, FieldFrame, FieldTimecode, FieldName, FieldSource, FieldIndex, FieldRef, FieldCount };
+
+	static const QStringList &fieldNames();
+
+	QString fileSuffix;
+	QString escapeName;
+	QString headerSource;
+	QString markerSource;
+	QString annotationSource;
+	QString footerSource;
+
+	TextTemplate header;
+	TextTemplate marker;
+	TextTemplate annotation;
+	TextTemplate footer;
+
+	bool compile();
+	// First error of the four templates, empty when all compiled
+	QString errorString() const;
+	bool usesField(int field) const;
+
+	// The suffix is appended to the recording's base name, it must not leave the recording folder
+	static bool isValidFileSuffix(const QString &suffix);
+};
+
+/**
+ * @struct ChapterNameTemplate
+ * @brief Fields available to the default and scene chapter name templates
+ */
+struct ChapterNameTemplate {
+	enum Field { FieldName, FieldNumber, FieldScene, FieldTime, FieldDate, FieldCount };
+
+	static const QStringList &fieldNames();
+};
+
+#endif // TEXT_TEMPLATE_HPP
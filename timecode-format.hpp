@@ -0,0 +1,190 @@
+#pragma once
+
+#ifndef TIMECODE_FORMAT_HPP
+#define TIMECODE_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @namespace Timecode
+ * @brief Locale-free formatting of frame offsets into caller-provided buffers
+ *
+ * Every formatter writes ASCII into out without a terminator and returns the
+ * number of characters written. Buffers of BUFFER_SIZE always fit. Nothing
+ * allocates and digits come from a constexpr pair table.
+ */
+namespace Timecode {
+
+constexpr size_t BUFFER_SIZE = 32;
+
+struct Timebase {
+	uint32_t fpsNum = 30;
+	uint32_t fpsDen = 1;
+
+	// Whole frames per second a timecode counts, 30 for 29.97
+	constexpr uint32_t nominalFps() const
+	{
+		return fpsDen == 0 ? 30 : static_cast<uint32_t>((fpsNum + fpsDen / 2) / fpsDen);
+	}
+
+	// 29.97 and 59.94 are the NTSC rates drop-frame timecode is defined for
+	constexpr bool isNtsc() const { return fpsDen == 1001 && (fpsNum == 30000 || fpsNum == 60000); }
+};
+
+namespace Detail {
+
+struct DigitPairs {
+	char chars[200];
+};
+
+constexpr DigitPairs makeDigitPairs()
+{
+	DigitPairs pairs{};
+	for (int i = 0; i < 100; ++i) {
+		pairs.chars[i * 2] = static_cast<char>('0' + i / 10);
+		pairs.chars[i * 2 + 1] = static_cast<char>('0' + i % 10);
+	}
+	return pairs;
+}
+
+constexpr DigitPairs DIGIT_PAIRS = makeDigitPairs();
+
+// Two digits, value must be below 100
+constexpr char *writeTwo(char *out, uint32_t value)
+{
+	out[0] = DIGIT_PAIRS.chars[value * 2];
+	out[1] = DIGIT_PAIRS.chars[value * 2 + 1];
+	return out + 2;
+}
+
+constexpr char *writeThree(char *out, uint32_t value)
+{
+	out[0] = static_cast<char>('0' + value / 100);
+	return writeTwo(out + 1, value % 100);
+}
+
+// At least two digits, hours past 99 simply get wider
+constexpr char *writeHours(char *out, uint64_t hours)
+{
+	if (hours < 100) {
+		return writeTwo(out, static_cast<uint32_t>(hours));
+	}
+	char digits[20] = {};
+	int count = 0;
+	while (hours > 0) {
+		digits[count++] = static_cast<char>('0' + hours % 10);
+		hours /= 10;
+	}
+	while (count > 0) {
+		*out++ = digits[--count];
+	}
+	return out;
+}
+
+} // namespace Detail
+
+constexpr uint64_t framesToMilliseconds(uint64_t frames, const Timebase &timebase)
+{
+	return timebase.fpsNum == 0 ? 0 : frames * 1000 * timebase.fpsDen / timebase.fpsNum;
+}
+
+// Wall-clock HH:MM:SS of a frame offset
+constexpr size_t formatHms(char *out, uint64_t frames, const Timebase &timebase)
+{
+	const uint64_t totalSeconds = framesToMilliseconds(frames, timebase) / 1000;
+	char *p = Detail::writeHours(out, totalSeconds / 3600);
+	*p++ = ':';
+	p = Detail::writeTwo(p, static_cast<uint32_t>(totalSeconds / 60 % 60));
+	*p++ = ':';
+	p = Detail::writeTwo(p, static_cast<uint32_t>(totalSeconds % 60));
+	return static_cast<size_t>(p - out);
+}
+
+// Wall-clock HH:MM:SS.mmm of a frame offset
+constexpr size_t formatHmsMillis(char *out, uint64_t frames, const Timebase &timebase)
+{
+	const uint64_t totalMs = framesToMilliseconds(frames, timebase);
+	const uint64_t totalSeconds = totalMs / 1000;
+	char *p = Detail::writeHours(out, totalSeconds / 3600);
+	*p++ = ':';
+	p = Detail::writeTwo(p, static_cast<uint32_t>(totalSeconds / 60 % 60));
+	*p++ = ':';
+	p = Detail::writeTwo(p, static_cast<uint32_t>(totalSeconds % 60));
+	*p++ = '.';
+	p = Detail::writeThree(p, static_cast<uint32_t>(totalMs % 1000));
+	return static_cast<size_t>(p - out);
+}
+
+/**
+ * SMPTE HH:MM:SS:FF counting frames at the nominal rate. Drop-frame only
+ * applies to NTSC rates and uses ';' before the frames as usual. separator
+ * replaces every ':' when set, Premiere writes drop-frame as HH;MM;SS;FF.
+ * hourOffset is added to the hours, EDL record times start at 01:00:00:00.
+ */
+constexpr size_t formatSmpte(char *out, uint64_t frames, const Timebase &timebase, bool dropFrame, char separator = 0,
+			     uint32_t hourOffset = 0)
+{
+	const uint64_t fps = timebase.nominalFps();
+	dropFrame = dropFrame && timebase.isNtsc();
+
+	if (dropFrame) {
+		// Skip frame numbers 0 and 1 (0-3 at 59.94) every minute except every tenth
+		const uint64_t dropped = fps / 15;
+		const uint64_t framesPer10Minutes = fps * 600 - dropped * 9;
+		const uint64_t framesPerMinute = fps * 60 - dropped;
+		const uint64_t tens = frames / framesPer10Minutes;
+		const uint64_t remainder = frames % framesPer10Minutes;
+		frames += dropped * 9 * tens;
+		if (remainder > dropped) {
+			frames += dropped * ((remainder - dropped) / framesPerMinute);
+		}
+	}
+
+	const char fieldSeparator = separator ? separator : ':';
+	const char frameSeparator = separator ? separator : (dropFrame ? ';' : ':');
+
+	const uint64_t totalSeconds = frames / fps;
+	char *p = Detail::writeHours(out, totalSeconds / 3600 + hourOffset);
+	*p++ = fieldSeparator;
+	p = Detail::writeTwo(p, static_cast<uint32_t>(totalSeconds / 60 % 60));
+	*p++ = fieldSeparator;
+	p = Detail::writeTwo(p, static_cast<uint32_t>(totalSeconds % 60));
+	*p++ = frameSeparator;
+	p = Detail::writeTwo(p, static_cast<uint32_t>(frames % fps % 100));
+	return static_cast<size_t>(p - out);
+}
+
+// Premiere XML timecode strings, always ';' separated
+constexpr size_t formatPremiere(char *out, uint64_t frames, const Timebase &timebase)
+{
+	return formatSmpte(out, frames, timebase, timebase.isNtsc(), ';');
+}
+
+// Raw decimal frame count
+constexpr size_t formatFrames(char *out, uint64_t frames)
+{
+	char digits[20] = {};
+	int count = 0;
+	do {
+		digits[count++] = static_cast<char>('0' + frames % 10);
+		frames /= 10;
+	} while (frames > 0);
+
+	size_t length = 0;
+	while (count > 0) {
+		out[length++] = digits[--count];
+	}
+	return length;
+}
+
+// Three digit EDL event number
+constexpr size_t formatEventNumber(char *out, uint32_t number)
+{
+	Detail::writeThree(out, number % 1000);
+	return 3;
+}
+
+} // namespace Timecode
+
+#endif // TIMECODE_FORMAT_HPP
@@ -0,0 +1,398 @@
+#include "webhook-sender.hpp"
+#include "text-escape.hpp"
+#include "version.h"
+#include <obs-module.h>
+#include <util/platform.h>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+qint64 monotonicMs()
+{
+	return static_cast<qint64>(os_gettime_ns() / 1000000);
+}
+
+size_t discardResponse(char *, size_t size, size_t count, void *)
+{
+	return size * count;
+}
+
+} // namespace
+
+WebhookSender::~WebhookSender()
+{
+	stop();
+}
+
+void WebhookSender::setEndpoints(const QStringList &urls)
+{
+	endpointUrls = urls;
+	if (urls.isEmpty() && !thread.joinable()) {
+		return;
+	}
+
+	if (!thread.joinable()) {
+		multi = curl_multi_init();
+		if (!multi) {
+			blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not start webhook sender");
+			return;
+		}
+		headers = curl_slist_append(headers, "Content-Type: application/json");
+		stopping = false;
+		thread = std::thread(&WebhookSender::run, this);
+	}
+
+	QMutexLocker locker(&mutex);
+	pendingUrls = urls;
+	endpointsChanged = true;
+	accepting.storeRelaxed(urls.isEmpty() ? 0 : 1);
+	curl_multi_wakeup(multi);
+}
+
+void WebhookSender::stop()
+{
+	if (!thread.joinable()) {
+		return;
+	}
+
+	{
+		QMutexLocker locker(&mutex);
+		stopping = true;
+		accepting.storeRelaxed(0);
+		curl_multi_wakeup(multi);
+	}
+	thread.join();
+
+	curl_multi_cleanup(multi);
+	multi = nullptr;
+	curl_slist_free_all(headers);
+	headers = nullptr;
+}
+
+void WebhookSender::post(const char *eventType, const char *eventJson)
+{
+	// Nothing is copied unless an endpoint is configured
+	if (!accepting.loadRelaxed()) {
+		return;
+	}
+
+	PendingEvent event{QByteArray(eventType), QDateTime::currentMSecsSinceEpoch(), QByteArray(eventJson ? eventJson : "{}")};
+	QMutexLocker locker(&mutex);
+	if (stopping) {
+		return;
+	}
+	incoming.append(std::move(event));
+	curl_multi_wakeup(multi);
+}
+
+void WebhookSender::run()
+{
+	std::vector<std::unique_ptr<Endpoint>> active;
+	bool spoolLoaded = false;
+	bool spoolOnDisk = false; // Delivering any event then has to rewrite the file
+	bool spoolPending = false;
+	qint64 nextSpoolWriteMs = 0;
+
+	for (;;) {
+		QVector<PendingEvent> events;
+		QStringList urls;
+		bool changed;
+		bool stopRequested;
+		{
+			QMutexLocker locker(&mutex);
+			events.swap(incoming);
+			urls = pendingUrls;
+			changed = endpointsChanged;
+			endpointsChanged = false;
+			stopRequested = stopping;
+		}
+
+		bool spoolDirty = false;
+		if (changed) {
+			applyEndpoints(active, urls);
+			// Events left over from the last session go to the endpoints that are still configured
+			if (!spoolLoaded) {
+				spoolOnDisk = loadSpool(active);
+				spoolLoaded = true;
+			} else {
+				spoolDirty = spoolOnDisk;
+			}
+		}
+		if (stopRequested) {
+			break;
+		}
+
+		// Events are converted once here and shared by every endpoint
+		for (const PendingEvent &event : events) {
+			const QByteArray compact = compactEvent(event);
+			for (const auto &endpoint : active) {
+				enqueue(*endpoint, compact);
+				spoolDirty = spoolDirty || endpoint->failures > 0;
+			}
+		}
+
+		qint64 nowMs = monotonicMs();
+		for (const auto &endpoint : active) {
+			if (!endpoint->inFlight && !endpoint->events.empty() && nowMs >= endpoint->retryAtMs) {
+				send(*endpoint);
+			}
+		}
+
+		int running = 0;
+		curl_multi_perform(multi, &running);
+
+		CURLMsg *message;
+		int messagesLeft = 0;
+		nowMs = monotonicMs();
+		while ((message = curl_multi_info_read(multi, &messagesLeft))) {
+			if (message->msg != CURLMSG_DONE) {
+				continue;
+			}
+			Endpoint *endpoint = nullptr;
+			curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char **>(&endpoint));
+			const CURLcode result = message->data.result;
+			curl_multi_remove_handle(multi, message->easy_handle);
+			if (endpoint) {
+				finish(*endpoint, result, nowMs, spoolDirty);
+				spoolDirty = spoolDirty || spoolOnDisk;
+			}
+		}
+
+		// A failing endpoint dirties the spool with every event, the file is rewritten at most once per interval
+		spoolPending = spoolPending || spoolDirty;
+		if (spoolPending && nowMs >= nextSpoolWriteMs) {
+			spoolOnDisk = writeSpool(active);
+			spoolPending = false;
+			nextSpoolWriteMs = nowMs + SPOOL_WRITE_INTERVAL_MS;
+		}
+
+		// Sleep until the next retry or spool write is due or post() wakes the thread
+		qint64 timeoutMs = 1000;
+		for (const auto &endpoint : active) {
+			if (!endpoint->inFlight && !endpoint->events.empty()) {
+				timeoutMs = std::min(timeoutMs, std::max<qint64>(0, endpoint->retryAtMs - nowMs));
+			}
+		}
+		if (spoolPending) {
+			timeoutMs = std::min(timeoutMs, std::max<qint64>(0, nextSpoolWriteMs - nowMs));
+		}
+		curl_multi_poll(multi, nullptr, 0, static_cast<int>(timeoutMs), nullptr);
+	}
+
+	// Requests still running are abandoned, their events are at the front of the queue and go to the spool
+	for (const auto &endpoint : active) {
+		if (endpoint->inFlight) {
+			curl_multi_remove_handle(multi, endpoint->handle);
+			endpoint->inFlight = 0;
+		}
+	}
+	writeSpool(active);
+	for (const auto &endpoint : active) {
+		curl_easy_cleanup(endpoint->handle);
+	}
+}
+
+void WebhookSender::applyEndpoints(std::vector<std::unique_ptr<Endpoint>> &active, const QStringList &urls)
+{
+	std::vector<std::unique_ptr<Endpoint>> updated;
+	for (const QString &url : urls) {
+		const QByteArray utf8Url = url.toUtf8();
+		auto existing = std::find_if(active.begin(), active.end(),
+					     [&](const std::unique_ptr<Endpoint> &endpoint) { return endpoint && endpoint->url == utf8Url; });
+		if (existing != active.end()) {
+			updated.push_back(std::move(*existing));
+			continue;
+		}
+		if (std::any_of(updated.begin(), updated.end(),
+				[&](const std::unique_ptr<Endpoint> &endpoint) { return endpoint->url == utf8Url; })) {
+			continue;
+		}
+
+		auto endpoint = std::make_unique<Endpoint>();
+		endpoint->url = utf8Url;
+		endpoint->handle = curl_easy_init();
+		if (!endpoint->handle) {
+			continue;
+		}
+
+		// The handle is reused for every request so the connection stays open
+		CURL *handle = endpoint->handle;
+		curl_easy_setopt(handle, CURLOPT_URL, endpoint->url.constData());
+		curl_easy_setopt(handle, CURLOPT_POST, 1L);
+		curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+		curl_easy_setopt(handle, CURLOPT_USERAGENT, "streamup-record-chapter-manager/" PROJECT_VERSION);
+		curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, REQUEST_TIMEOUT_MS);
+		curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, REQUEST_TIMEOUT_MS / 2);
+		curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+		curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+		curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, discardResponse);
+		curl_easy_setopt(handle, CURLOPT_PRIVATE, endpoint.get());
+		updated.push_back(std::move(endpoint));
+	}
+
+	// Endpoints removed from the settings drop what they still had queued
+	for (const auto &endpoint : active) {
+		if (!endpoint) {
+			continue;
+		}
+		if (endpoint->inFlight) {
+			curl_multi_remove_handle(multi, endpoint->handle);
+		}
+		curl_easy_cleanup(endpoint->handle);
+	}
+	active = std::move(updated);
+}
+
+void WebhookSender::send(Endpoint &endpoint)
+{
+	const int count = std::min(static_cast<int>(endpoint.events.size()), MAX_BATCH_EVENTS);
+	endpoint.body = "[";
+	for (int i = 0; i < count; ++i) {
+		if (i > 0) {
+			endpoint.body += ',';
+		}
+		endpoint.body += endpoint.events[static_cast<size_t>(i)];
+	}
+	endpoint.body += ']';
+
+	curl_easy_setopt(endpoint.handle, CURLOPT_POSTFIELDS, endpoint.body.constData());
+	curl_easy_setopt(endpoint.handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(endpoint.body.size()));
+	if (curl_multi_add_handle(multi, endpoint.handle) == CURLM_OK) {
+		endpoint.inFlight = count;
+	}
+}
+
+void WebhookSender::finish(Endpoint &endpoint, CURLcode result, qint64 nowMs, bool &spoolDirty)
+{
+	long status = 0;
+	curl_easy_getinfo(endpoint.handle, CURLINFO_RESPONSE_CODE, &status);
+	const bool delivered = result == CURLE_OK && status >= 200 && status < 300;
+	// The endpoint refused this batch, sending it again would not change the answer
+	const bool rejected = result == CURLE_OK && status >= 400 && status < 500 && status != 408 && status != 429;
+
+	if (delivered || rejected) {
+		if (rejected) {
+			blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Webhook %s rejected %d events with HTTP %ld",
+			     endpoint.url.constData(), endpoint.inFlight, status);
+		}
+		endpoint.events.erase(endpoint.events.begin(), endpoint.events.begin() + endpoint.inFlight);
+		if (endpoint.failures > 0) {
+			blog(LOG_INFO, "[StreamUP Record Chapter Manager] Webhook %s reachable again after %d failed attempts",
+			     endpoint.url.constData(), endpoint.failures);
+			spoolDirty = true;
+		}
+		endpoint.failures = 0;
+		endpoint.retryAtMs = 0;
+	} else {
+		++endpoint.failures;
+		const qint64 backoffMs =
+			std::min<qint64>(static_cast<qint64>(RETRY_BASE_MS) << std::min(endpoint.failures - 1, 16), RETRY_MAX_MS);
+		// Jitter keeps several instances from retrying in step
+		const qint64 delayMs = backoffMs + QRandomGenerator::global()->bounded(backoffMs / 4 + 1);
+		endpoint.retryAtMs = nowMs + delayMs;
+		spoolDirty = true;
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Webhook %s failed (%s, HTTP %ld), retrying in %lld ms",
+		     endpoint.url.constData(), curl_easy_strerror(result), status, static_cast<long long>(delayMs));
+	}
+	endpoint.inFlight = 0;
+	endpoint.body.clear();
+}
+
+void WebhookSender::enqueue(Endpoint &endpoint, const QByteArray &event)
+{
+	endpoint.events.push_back(event);
+	if (static_cast<int>(endpoint.events.size()) <= MAX_QUEUED_EVENTS) {
+		return;
+	}
+
+	// Events of the running request stay, the oldest after them make room
+	endpoint.events.erase(endpoint.events.begin() + endpoint.inFlight);
+	if (endpoint.dropped++ % 100 == 0) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Webhook %s queue is full, dropped %lld events so far",
+		     endpoint.url.constData(), static_cast<long long>(endpoint.dropped));
+	}
+}
+
+bool WebhookSender::loadSpool(std::vector<std::unique_ptr<Endpoint>> &active)
+{
+	QFile file(spoolPath);
+	if (spoolPath.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+
+	int restored = 0;
+	while (!file.atEnd()) {
+		const QJsonObject line = QJsonDocument::fromJson(file.readLine()).object();
+		const QByteArray url = line.value("url").toString().toUtf8();
+		const QJsonObject event = line.value("event").toObject();
+		if (url.isEmpty() || event.isEmpty()) {
+			continue;
+		}
+		for (const auto &endpoint : active) {
+			if (endpoint->url == url) {
+				enqueue(*endpoint, QJsonDocument(event).toJson(QJsonDocument::Compact));
+				++restored;
+				break;
+			}
+		}
+	}
+
+	if (restored > 0) {
+		blog(LOG_INFO, "[StreamUP Record Chapter Manager] Restored %d undelivered webhook events", restored);
+	}
+	return true;
+}
+
+bool WebhookSender::writeSpool(const std::vector<std::unique_ptr<Endpoint>> &active) const
+{
+	if (spoolPath.isEmpty()) {
+		return false;
+	}
+
+	bool empty = true;
+	QSaveFile file(spoolPath);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return true;
+	}
+	// Queued events are already compact JSON, each line wraps them without parsing: {"url":"...","event":{...}}
+	QByteArray line;
+	for (const auto &endpoint : active) {
+		const QByteArray &url = endpoint->url;
+		QByteArray prefix = "{\"url\":\"";
+		TextEscape::append(prefix, url.constData(), static_cast<size_t>(url.size()), TextEscape::Mode::Json);
+		prefix += "\",\"event\":";
+		for (const QByteArray &event : endpoint->events) {
+			line.resize(0);
+			line += prefix;
+			line += event;
+			line += "}\n";
+			file.write(line);
+			empty = false;
+		}
+	}
+
+	if (empty) {
+		file.cancelWriting();
+		QFile::remove(spoolPath);
+		return false;
+	}
+	if (!file.commit()) {
+		blog(LOG_WARNING, "[StreamUP Record Chapter Manager] Could not write webhook spool: %s",
+		     spoolPath.toUtf8().constData());
+	}
+	return true;
+}
+
+QByteArray WebhookSender::compactEvent(const PendingEvent &event)
+{
+	QJsonObject object{{"eventType", QString::fromUtf8(event.eventType)}, {"timestampMs", event.timestampMs}};
+	object.insert("eventData", QJsonDocument::fromJson(event.eventJson).object());
+	return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
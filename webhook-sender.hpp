@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef WEBHOOK_SENDER_HPP
+#define WEBHOOK_SENDER_HPP
+
+#include <curl/curl.h>
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WebhookSender
+ * @brief Posts chapter events to HTTP endpoints from its own thread
+ *
+ * post() only copies the event into a queue and wakes the sender thread, so
+ * marker capture never waits on the network. The thread drives a single curl
+ * multi handle: every endpoint keeps its own easy handle, so connections stay
+ * alive between requests, and all endpoints are sent to at the same time.
+ * Events that queue up while a request is running go out together as one
+ * JSON array, at most MAX_BATCH_EVENTS per request.
+ *
+ * A failed request keeps its events at the front of the endpoint's queue and
+ * retries with exponential backoff. Each queue is bounded, the oldest events
+ * are dropped first. While an endpoint is failing its queue is written to the
+ * spool file, at most once every SPOOL_WRITE_INTERVAL_MS and on stop. The file
+ * is read back when the sender starts again, so undelivered events survive a
+ * restart of OBS.
+ *
+ * Endpoints are plain URLs, pointing one at a local HTTP server is enough to
+ * watch what is sent.
+ */
+class WebhookSender {
+public:
+	static constexpr int MAX_BATCH_EVENTS = 50;
+	static constexpr int MAX_QUEUED_EVENTS = 1000; // Per endpoint
+	static constexpr int RETRY_BASE_MS = 1000;
+	static constexpr int RETRY_MAX_MS = 5 * 60 * 1000;
+	static constexpr long REQUEST_TIMEOUT_MS = 10000;
+	static constexpr int SPOOL_WRITE_INTERVAL_MS = RETRY_BASE_MS;
+
+	~WebhookSender();
+
+	void setSpoolPath(const QString &filePath) { spoolPath = filePath; }
+	// Starts the sender thread for the first endpoints, an empty list stops queueing events
+	void setEndpoints(const QStringList &urls);
+	const QStringList &endpoints() const { return endpointUrls; }
+	// Sends what is still queued to the spool file and joins the thread
+	void stop();
+
+	// Safe from any thread, returns at once
+	void post(const char *eventType, const char *eventJson);
+
+private:
+	struct PendingEvent {
+		QByteArray eventType;
+		qint64 timestampMs;
+		QByteArray eventJson;
+	};
+
+	struct Endpoint {
+		QByteArray url;
+		CURL *handle = nullptr;
+		std::deque<QByteArray> events; // Compact JSON, the request in flight sends the first inFlight
+		int inFlight = 0;
+		QByteArray body; // Kept alive while the request runs
+		int failures = 0;
+		qint64 retryAtMs = 0;
+		qint64 dropped = 0;
+	};
+
+	void run();
+	void applyEndpoints(std::vector<std::unique_ptr<Endpoint>> &active, const QStringList &urls);
+	void send(Endpoint &endpoint);
+	void finish(Endpoint &endpoint, CURLcode result, qint64 nowMs, bool &spoolDirty);
+	void enqueue(Endpoint &endpoint, const QByteArray &event);
+	// Both return whether the spool file holds events afterwards
+	bool loadSpool(std::vector<std::unique_ptr<Endpoint>> &active);
+	bool writeSpool(const std::vector<std::unique_ptr<Endpoint>> &active) const;
+	static QByteArray compactEvent(const PendingEvent &event);
+
+	QString spoolPath;
+	QStringList endpointUrls; // UI thread copy
+
+	QMutex mutex; // Guards everything below
+	QVector<PendingEvent> incoming;
+	QStringList pendingUrls;
+	bool endpointsChanged = false;
+	bool stopping = false;
+
+	QAtomicInteger<int> accepting = 0;
+	CURLM *multi = nullptr;
+	curl_slist *headers = nullptr;
+	std::thread thread;
+};
+
+#endif // WEBHOOK_SENDER_HPP